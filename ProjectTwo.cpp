@@ -1,345 +1,3418 @@
-// ProjectTwo.cpp - ABCU Advising Assistance Program
-// William Vanderlinden
-// Data structure choice: Hash table (std::unordered_map) for fast lookups.
-//
-// Requirements implemented:
-//  - Prompt for filename
-//  - Menu options: 1 Load, 2 Print sorted list, 3 Print course info, 9 Exit
-//  - Two-pass load with prerequisite validation (skip bad lines; do not exit on line errors)
-//  - Print sorted courses (alphanumeric by course number)
-//  - Print course title + prerequisite course numbers and titles
-//
-// Notes:
-//  - Single CPP file, no CSVParser headers used
-//  - Uses basic CSV split on commas (no quoted-field handling)
-
-#include <algorithm>
-#include <cctype>
-#include <fstream>
-#include <iostream>
-#include <sstream>
-#include <string>
-#include <unordered_map>
-#include <unordered_set>
-#include <vector>
-
-struct Course {
-    std::string courseNumber;
-    std::string title;
-    std::vector<std::string> prerequisites;
-};
-
-// ---------- Utility helpers ----------
-
-static inline std::string trim(const std::string& s) {
-    size_t start = 0;
-    while (start < s.size() && std::isspace(static_cast<unsigned char>(s[start]))) start++;
-    size_t end = s.size();
-    while (end > start && std::isspace(static_cast<unsigned char>(s[end - 1]))) end--;
-    return s.substr(start, end - start);
-}
-
-// Uppercases a course number for consistent matching (e.g., "cs200" -> "CS200").
-static inline std::string normalizeCourseNumber(const std::string& s) {
-    std::string t = trim(s);
-    for (char& ch : t) ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
-    return t;
-}
-
-// Simple CSV split by comma (no quotes support).
-static std::vector<std::string> splitByComma(const std::string& line) {
-    std::vector<std::string> tokens;
-    std::string token;
-    std::stringstream ss(line);
-    while (std::getline(ss, token, ',')) {
-        tokens.push_back(trim(token));
-    }
-    // Handle trailing comma -> add empty token if line ends with comma
-    if (!line.empty() && line.back() == ',') {
-        tokens.push_back("");
-    }
-    return tokens;
-}
-
-// ---------- Core program functions ----------
-
-using CourseTable = std::unordered_map<std::string, Course>;
-
-static CourseTable loadCoursesFromFile(const std::string& fileName) {
-    CourseTable coursesTable;
-    std::unordered_set<std::string> allCourseNumbers;
-
-    // ----- Pass 1: collect valid course IDs -----
-    {
-        std::ifstream in(fileName);
-        if (!in.is_open()) {
-            std::cerr << "ERROR: Could not open file: " << fileName << "\n";
-            return coursesTable;
-        }
-
-        std::string line;
-        int lineNumber = 0;
-        while (std::getline(in, line)) {
-            lineNumber++;
-
-            if (trim(line).empty()) {
-                continue; // skip empty lines
-            }
-
-            auto tokens = splitByComma(line);
-
-            // Must have at least courseNumber + title
-            if (tokens.size() < 2) {
-                std::cerr << "ERROR: Bad format on line " << lineNumber << " (skipping line)\n";
-                continue;
-            }
-
-            std::string courseNum = normalizeCourseNumber(tokens[0]);
-            std::string title = trim(tokens[1]);
-
-            if (courseNum.empty() || title.empty()) {
-                std::cerr << "ERROR: Missing courseNumber/title on line " << lineNumber
-                    << " (skipping line)\n";
-                continue;
-            }
-
-            if (allCourseNumbers.find(courseNum) != allCourseNumbers.end()) {
-                std::cerr << "ERROR: Duplicate courseNumber '" << courseNum << "' on line "
-                    << lineNumber << " (skipping line)\n";
-                continue;
-            }
-
-            allCourseNumbers.insert(courseNum);
-        }
-    }
-
-    // ----- Pass 2: validate prereqs and insert valid courses -----
-    {
-        std::ifstream in(fileName);
-        if (!in.is_open()) {
-            std::cerr << "ERROR: Could not open file: " << fileName << "\n";
-            return coursesTable;
-        }
-
-        std::string line;
-        int lineNumber = 0;
-        while (std::getline(in, line)) {
-            lineNumber++;
-
-            if (trim(line).empty()) {
-                continue;
-            }
-
-            auto tokens = splitByComma(line);
-
-            if (tokens.size() < 2) {
-                std::cerr << "ERROR: Bad format on line " << lineNumber << " (skipping line)\n";
-                continue;
-            }
-
-            std::string courseNum = normalizeCourseNumber(tokens[0]);
-            std::string title = trim(tokens[1]);
-
-            if (courseNum.empty() || title.empty()) {
-                std::cerr << "ERROR: Missing courseNumber/title on line " << lineNumber
-                    << " (skipping line)\n";
-                continue;
-            }
-
-            // Validate prerequisites (courses may have NONE)
-            bool prereqIsValid = true;
-            for (size_t i = 2; i < tokens.size(); i++) {
-                std::string prereq = normalizeCourseNumber(tokens[i]);
-
-                // Ignore blank prereq tokens (treat as no prerequisite)
-                if (prereq.empty()) {
-                    continue;
-                }
-
-                if (allCourseNumbers.find(prereq) == allCourseNumbers.end()) {
-                    std::cerr << "ERROR: Line " << lineNumber << " invalid prerequisite '" << prereq
-                        << "' for course '" << courseNum << "' (skipping course)\n";
-                    prereqIsValid = false;
-                    break;
-                }
-            }
-
-            if (!prereqIsValid) {
-                continue; // IMPORTANT: do not insert this course
-            }
-
-            // Build course object
-            Course c;
-            c.courseNumber = courseNum;
-            c.title = title;
-            c.prerequisites.clear();
-
-            for (size_t i = 2; i < tokens.size(); i++) {
-                std::string prereq = normalizeCourseNumber(tokens[i]);
-                if (!prereq.empty()) {
-                    c.prerequisites.push_back(prereq);
-                }
-            }
-
-            // Insert into hash table (duplicate keys should not occur due to pass 1,
-            // but we guard anyway by skipping if already present)
-            if (coursesTable.find(c.courseNumber) == coursesTable.end()) {
-                coursesTable[c.courseNumber] = c;
-            }
-        }
-    }
-
-    return coursesTable;
-}
-
-static void printCourseListSorted(const CourseTable& coursesTable) {
-    if (coursesTable.empty()) {
-        std::cout << "No course data loaded.\n";
-        return;
-    }
-
-    std::vector<std::string> courseNums;
-    courseNums.reserve(coursesTable.size());
-    for (const auto& kv : coursesTable) {
-        courseNums.push_back(kv.first);
-    }
-
-    std::sort(courseNums.begin(), courseNums.end()); // alphanumeric by course number
-
-    for (const auto& num : courseNums) {
-        const Course& c = coursesTable.at(num);
-        std::cout << c.courseNumber << ", " << c.title << "\n";
-    }
-}
-
-static void printCourseInfo(const CourseTable& coursesTable, const std::string& inputCourseNumber) {
-    if (coursesTable.empty()) {
-        std::cout << "No course data loaded.\n";
-        return;
-    }
-
-    std::string courseNumber = normalizeCourseNumber(inputCourseNumber);
-    auto it = coursesTable.find(courseNumber);
-    if (it == coursesTable.end()) {
-        std::cout << "Course not found: " << courseNumber << "\n";
-        return;
-    }
-
-    const Course& course = it->second;
-    std::cout << course.courseNumber << ", " << course.title << "\n";
-
-    if (course.prerequisites.empty()) {
-        std::cout << "Prerequisites: None\n";
-        return;
-    }
-
-    std::cout << "Prerequisites:\n";
-    for (const auto& prereqNum : course.prerequisites) {
-        auto pit = coursesTable.find(prereqNum);
-        if (pit != coursesTable.end()) {
-            std::cout << "  " << pit->second.courseNumber << ", " << pit->second.title << "\n";
-        }
-        else {
-            // Should not happen due to validation, but keep safe fallback
-            std::cout << "  " << prereqNum << " (missing info)\n";
-        }
-    }
-}
-
-static void printMenu() {
-    std::cout << "\nMenu:\n";
-    std::cout << "  1. Load Data Structure\n";
-    std::cout << "  2. Print Course List\n";
-    std::cout << "  3. Print Course\n";
-    std::cout << "  9. Exit\n";
-    std::cout << "Enter your choice: ";
-}
-
-static bool readIntChoice(int& outChoice) {
-    std::string line;
-    if (!std::getline(std::cin, line)) return false;
-    line = trim(line);
-    if (line.empty()) return false;
-
-    // Basic numeric parse
-    try {
-        size_t idx = 0;
-        int val = std::stoi(line, &idx);
-        if (idx != line.size()) return false;
-        outChoice = val;
-        return true;
-    }
-    catch (...) {
-        return false;
-    }
-}
-
-int main() {
-    std::cout << "Welcome to ABCU Advising Program\n";
-
-    CourseTable coursesTable;
-    bool dataLoaded = false;
-
-    // Prompt user for the filename up front (required by the prompt).
-    std::string fileName;
-    std::cout << "Enter the course data file name: ";
-    std::getline(std::cin, fileName);
-    fileName = trim(fileName);
-
-    int choice = 0;
-    while (true) {
-        printMenu();
-        if (!readIntChoice(choice)) {
-            std::cout << "Invalid input. Please enter 1, 2, 3, or 9.\n";
-            continue;
-        }
-
-        if (choice == 1) {
-            if (fileName.empty()) {
-                std::cout << "Enter the course data file name: ";
-                std::getline(std::cin, fileName);
-                fileName = trim(fileName);
-            }
-
-            coursesTable = loadCoursesFromFile(fileName);
-            if (!coursesTable.empty()) {
-                dataLoaded = true;
-                std::cout << "Data loaded successfully (" << coursesTable.size() << " courses).\n";
-            }
-            else {
-                dataLoaded = false;
-                std::cout << "No courses loaded. Check errors above and try again.\n";
-            }
-
-        }
-        else if (choice == 2) {
-            if (!dataLoaded) {
-                std::cout << "Please load data first (Option 1).\n";
-                continue;
-            }
-            printCourseListSorted(coursesTable);
-
-        }
-        else if (choice == 3) {
-            if (!dataLoaded) {
-                std::cout << "Please load data first (Option 1).\n";
-                continue;
-            }
-            std::string courseNumber;
-            std::cout << "Enter a course number (e.g., CS200): ";
-            std::getline(std::cin, courseNumber);
-            printCourseInfo(coursesTable, courseNumber);
-
-        }
-        else if (choice == 9) {
-            std::cout << "Goodbye.\n";
-            break;
-
-        }
-        else {
-            std::cout << "Invalid option. Please enter 1, 2, 3, or 9.\n";
-        }
-    }
-
-    return 0;
+// ProjectTwo.cpp - ABCU Advising Assistance Program
+// William Vanderlinden
+// Data structure choice: Hash table (std::unordered_map) for fast lookups.
+//
+// Requirements implemented:
+//  - Prompt for filename
+//  - Menu options: 1 Load, 2 Print sorted list, 3 Print course info, 9 Exit
+//  - Single-pass load with deferred prerequisite validation (skip bad lines; do not exit on line errors)
+//  - Print sorted courses (alphanumeric by course number)
+//  - Print course title + prerequisite course numbers and titles
+//
+// Notes:
+//  - Single CPP file, no CSVParser headers used
+//  - Uses basic CSV split on commas (no quoted-field handling)
+//  - On POSIX systems the file is memory-mapped and parsed zero-copy as
+//    string_view slices; elsewhere it falls back to a one-shot read
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ABCU_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__)
+#define ABCU_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Dense interned id for a course number. Ids index Catalog::numberPool; every
+// distinct course number in a load (including ones only ever referenced as a
+// prerequisite) gets exactly one id, so the text exists once in memory.
+using CourseId = uint32_t;
+static constexpr uint32_t kNoCourseIndex = 0xFFFFFFFFu;
+
+struct Course {
+    CourseId number = 0;                 // interned course-number id
+    std::string_view title;              // bytes owned by the Catalog's arena
+    std::vector<CourseId> prerequisites; // interned ids, resolved via Catalog
+};
+
+// ---------- Utility helpers ----------
+
+// Finds the next occurrence of `c` at or after `from`, 16 bytes per step on
+// SSE2 targets. Returns npos if absent. This is the delimiter scan under both
+// the line walk ('\n') and the field split (',') in the parse hot path.
+static inline size_t findByte(std::string_view s, char c, size_t from) {
+    if (from >= s.size()) return std::string_view::npos;
+#if ABCU_HAVE_SSE2
+    const char* base = s.data();
+    const char* p = base + from;
+    size_t n = s.size() - from;
+    const __m128i needle = _mm_set1_epi8(c);
+    while (n >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, needle));
+        if (mask != 0) {
+            return static_cast<size_t>(p - base) + static_cast<size_t>(__builtin_ctz(mask));
+        }
+        p += 16;
+        n -= 16;
+    }
+    const void* hit = std::memchr(p, c, n);
+    if (hit == nullptr) return std::string_view::npos;
+    return static_cast<size_t>(static_cast<const char*>(hit) - base);
+#else
+    const void* hit = std::memchr(s.data() + from, c, s.size() - from);
+    if (hit == nullptr) return std::string_view::npos;
+    return static_cast<size_t>(static_cast<const char*>(hit) - s.data());
+#endif
+}
+
+// ASCII-uppercases a buffer in place, 16 bytes per step on SSE2 targets.
+// Course numbers are plain ASCII, so this replaces the per-char toupper walk.
+static inline void toUpperAscii(char* data, size_t n) {
+    size_t i = 0;
+#if ABCU_HAVE_SSE2
+    const __m128i belowA = _mm_set1_epi8('a' - 1);
+    const __m128i aboveZ = _mm_set1_epi8('z' + 1);
+    const __m128i caseBit = _mm_set1_epi8(0x20);
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i isLower = _mm_and_si128(_mm_cmpgt_epi8(v, belowA), _mm_cmpgt_epi8(aboveZ, v));
+        v = _mm_xor_si128(v, _mm_and_si128(isLower, caseBit));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), v);
+    }
+#endif
+    for (; i < n; i++) {
+        data[i] = static_cast<char>(std::toupper(static_cast<unsigned char>(data[i])));
+    }
+}
+
+static inline std::string trim(const std::string& s) {
+    size_t start = 0;
+    while (start < s.size() && std::isspace(static_cast<unsigned char>(s[start]))) start++;
+    size_t end = s.size();
+    while (end > start && std::isspace(static_cast<unsigned char>(s[end - 1]))) end--;
+    return s.substr(start, end - start);
+}
+
+// Uppercases a course number for consistent matching (e.g., "cs200" -> "CS200").
+static inline std::string normalizeCourseNumber(const std::string& s) {
+    std::string t = trim(s);
+    toUpperAscii(t.data(), t.size());
+    return t;
+}
+
+// View-based trim: no copy, just narrows the slice.
+static inline std::string_view trimView(std::string_view s) {
+    size_t start = 0;
+    while (start < s.size() && std::isspace(static_cast<unsigned char>(s[start]))) start++;
+    size_t end = s.size();
+    while (end > start && std::isspace(static_cast<unsigned char>(s[end - 1]))) end--;
+    return s.substr(start, end - start);
+}
+
+// View overload: only materializes the owning string here, at the point a
+// course number is actually kept.
+static inline std::string normalizeCourseNumber(std::string_view s) {
+    std::string_view v = trimView(s);
+    std::string t(v);
+    toUpperAscii(t.data(), t.size());
+    return t;
+}
+
+// Loader overload: normalizes without owning in the common case. A token that
+// is already upper-case (nearly every row of a real export) comes back as a
+// trimmed view into the caller's buffer; only tokens that actually need
+// rewriting are copied, into `ownedText`, whose nodes stay put as it grows.
+static inline std::string_view normalizeCourseNumber(std::string_view s,
+    std::list<std::string>& ownedText) {
+    std::string_view t = trimView(s);
+    bool hasLower = false;
+    for (char c : t) {
+        if (c >= 'a' && c <= 'z') {
+            hasLower = true;
+            break;
+        }
+    }
+    if (!hasLower) return t;
+    ownedText.emplace_back(t);
+    std::string& upper = ownedText.back();
+    toUpperAscii(upper.data(), upper.size());
+    return upper;
+}
+
+// Simple CSV split by comma (no quotes support). Tokens are trimmed views into
+// the original line; `tokens` is reused across calls to avoid reallocation.
+static void splitByComma(std::string_view line, std::vector<std::string_view>& tokens) {
+    tokens.clear();
+    size_t pos = 0;
+    while (true) {
+        size_t comma = findByte(line, ',', pos);
+        if (comma == std::string_view::npos) {
+            tokens.push_back(trimView(line.substr(pos)));
+            break;
+        }
+        tokens.push_back(trimView(line.substr(pos, comma - pos)));
+        pos = comma + 1;
+    }
+}
+
+// ---------- Instrumentation ----------
+
+// Always-on operating counters: per-operation log2 latency histograms, hash
+// probe lengths, and arena allocation counts. The catalog publication
+// contract lets any number of reader threads run lookups lock-free, so the
+// counters cannot be shared plain globals: every thread gets its own block,
+// registered once and summed at report time. Within a block there is a
+// single writer, so updates are relaxed atomic load/store pairs -- no locks,
+// no contended cache lines, and on mainstream targets the same plain
+// read-modify-write a non-atomic add would be -- cheap enough to leave
+// enabled in production. Surfaced through menu option 13 and the batch
+// `stats` command, and dumped as key=value lines to the file named by
+// $ABCU_STATS_FILE on exit when that variable is set.
+
+// Single-writer increment: the owning thread is the only writer, the report
+// only ever reads, so relaxed ordering is enough and fetch_add's lock prefix
+// is not needed.
+static inline void bumpCounter(std::atomic<uint64_t>& counter, uint64_t by) {
+    counter.store(counter.load(std::memory_order_relaxed) + by,
+        std::memory_order_relaxed);
+}
+
+struct LatencyHistogram {
+    std::atomic<uint64_t> count{ 0 };
+    std::atomic<uint64_t> totalNs{ 0 };
+    std::atomic<uint64_t> maxNs{ 0 };
+    std::atomic<uint64_t> buckets[40]{}; // bucket b counts samples below 2^(b+1) ns
+
+    void record(uint64_t ns) {
+        bumpCounter(count, 1);
+        bumpCounter(totalNs, ns);
+        if (ns > maxNs.load(std::memory_order_relaxed)) {
+            maxNs.store(ns, std::memory_order_relaxed);
+        }
+        unsigned b = 0;
+        while (b + 1 < 40 && (uint64_t(1) << (b + 1)) <= ns) b++;
+        bumpCounter(buckets[b], 1);
+    }
+};
+
+struct PerfStats {
+    LatencyHistogram loadLatency;           // CSV, snapshot, and delta loads
+    LatencyHistogram listLatency;           // option-2 listing
+    LatencyHistogram lookupLatency;         // option-3 lookups
+    std::atomic<uint64_t> probeCount{ 0 };  // CourseNumberIndex::find calls
+    std::atomic<uint64_t> probeSteps{ 0 };  // slots touched across all finds
+    std::atomic<uint64_t> probeMax{ 0 };    // longest single probe chain
+    std::atomic<uint64_t> arenaChunks{ 0 }; // StringArena chunk allocations
+    std::atomic<uint64_t> arenaBytes{ 0 };  // string bytes interned
+    std::atomic<uint64_t> bloomRejects{ 0 }; // lookups rejected before probing
+};
+
+static std::mutex statsRegistryLock;
+static std::vector<std::shared_ptr<PerfStats>> statsBlocks;
+
+// The calling thread's private counter block, registered on first use.
+// Blocks are shared_ptr-owned by the registry, so a worker's counts survive
+// its exit and still show up in later reports.
+static PerfStats& localPerfStats() {
+    thread_local std::shared_ptr<PerfStats> block = [] {
+        std::shared_ptr<PerfStats> fresh = std::make_shared<PerfStats>();
+        std::lock_guard<std::mutex> lock(statsRegistryLock);
+        statsBlocks.push_back(fresh);
+        return fresh;
+    }();
+    return *block;
+}
+
+// Plain-integer totals for the report path, summed across all thread blocks.
+struct LatencyTotals {
+    uint64_t count = 0;
+    uint64_t totalNs = 0;
+    uint64_t maxNs = 0;
+    uint64_t buckets[40] = {};
+};
+
+struct PerfTotals {
+    LatencyTotals loadLatency;
+    LatencyTotals listLatency;
+    LatencyTotals lookupLatency;
+    uint64_t probeCount = 0;
+    uint64_t probeSteps = 0;
+    uint64_t probeMax = 0;
+    uint64_t arenaChunks = 0;
+    uint64_t arenaBytes = 0;
+    uint64_t bloomRejects = 0;
+};
+
+static PerfTotals gatherPerfStats() {
+    PerfTotals total;
+    auto addHistogram = [](LatencyTotals& t, const LatencyHistogram& h) {
+        t.count += h.count.load(std::memory_order_relaxed);
+        t.totalNs += h.totalNs.load(std::memory_order_relaxed);
+        t.maxNs = std::max(t.maxNs, h.maxNs.load(std::memory_order_relaxed));
+        for (unsigned b = 0; b < 40; b++) {
+            t.buckets[b] += h.buckets[b].load(std::memory_order_relaxed);
+        }
+    };
+    std::lock_guard<std::mutex> lock(statsRegistryLock);
+    for (const auto& block : statsBlocks) {
+        addHistogram(total.loadLatency, block->loadLatency);
+        addHistogram(total.listLatency, block->listLatency);
+        addHistogram(total.lookupLatency, block->lookupLatency);
+        total.probeCount += block->probeCount.load(std::memory_order_relaxed);
+        total.probeSteps += block->probeSteps.load(std::memory_order_relaxed);
+        total.probeMax =
+            std::max(total.probeMax, block->probeMax.load(std::memory_order_relaxed));
+        total.arenaChunks += block->arenaChunks.load(std::memory_order_relaxed);
+        total.arenaBytes += block->arenaBytes.load(std::memory_order_relaxed);
+        total.bloomRejects += block->bloomRejects.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// Records one operation's wall time into the given histogram on scope exit.
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& h)
+        : histogram(h), start(std::chrono::steady_clock::now()) {
+    }
+    ~ScopedLatency() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        histogram.record(static_cast<uint64_t>(ns));
+    }
+
+private:
+    LatencyHistogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+// ---------- File ingestion ----------
+
+// Read-only view over the raw bytes of the course data file. On POSIX this is
+// a zero-copy mmap; otherwise `fallback` owns a one-shot read of the file.
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+    bool ok = false;
+
+#if ABCU_HAVE_MMAP
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+#endif
+    std::string fallback;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    explicit MappedFile(const std::string& fileName) {
+#if ABCU_HAVE_MMAP
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            struct stat st {};
+            if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+                if (st.st_size == 0) {
+                    ok = true; // empty file: valid, nothing to map
+                    ::close(fd);
+                    return;
+                }
+                void* m = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                    MAP_PRIVATE, fd, 0);
+                if (m != MAP_FAILED) {
+                    mapping = m;
+                    mappingSize = static_cast<size_t>(st.st_size);
+                    data = static_cast<const char*>(m);
+                    size = mappingSize;
+                    ok = true;
+                    // Kick off kernel readahead so page-ins overlap parsing:
+                    // this is the loader's asynchronous I/O stage.
+                    ::posix_madvise(mapping, mappingSize, POSIX_MADV_SEQUENTIAL);
+                    ::posix_madvise(mapping, mappingSize, POSIX_MADV_WILLNEED);
+                    ::close(fd);
+                    return;
+                }
+            }
+            ::close(fd);
+        }
+#endif
+        // Fallback: read the whole file in one shot.
+        std::ifstream in(fileName, std::ios::binary);
+        if (!in.is_open()) {
+            return;
+        }
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        fallback = ss.str();
+        data = fallback.data();
+        size = fallback.size();
+        ok = true;
+    }
+
+    ~MappedFile() {
+#if ABCU_HAVE_MMAP
+        if (mapping != nullptr) {
+            ::munmap(mapping, mappingSize);
+        }
+#endif
+    }
+
+    std::string_view view() const { return std::string_view(data, size); }
+};
+
+// ---------- String arena ----------
+
+// Bump allocator that owns every course-number and title byte for one load
+// generation. Storing a string is a pointer bump into the current chunk, and
+// tearing a catalog down (menu option 1 re-invoked) releases a handful of
+// chunks instead of freeing one heap string per course.
+class StringArena {
+public:
+    std::string_view store(std::string_view s) {
+        if (s.empty()) return std::string_view();
+        bumpCounter(localPerfStats().arenaBytes, s.size());
+        if (s.size() > kChunkSize) {
+            // Oversized string: give it a dedicated chunk, keep current one.
+            bumpCounter(localPerfStats().arenaChunks, 1);
+            chunks.emplace_back(new char[s.size()]);
+            char* dst = chunks.back().get();
+            std::memcpy(dst, s.data(), s.size());
+            if (chunks.size() >= 2) {
+                std::swap(chunks[chunks.size() - 2], chunks.back());
+            }
+            else {
+                used = kChunkSize; // lone oversized chunk: never bump into it
+            }
+            return std::string_view(dst, s.size());
+        }
+        if (chunks.empty() || used + s.size() > kChunkSize) {
+            bumpCounter(localPerfStats().arenaChunks, 1);
+            chunks.emplace_back(new char[kChunkSize]);
+            used = 0;
+        }
+        char* dst = chunks.back().get() + used;
+        std::memcpy(dst, s.data(), s.size());
+        used += s.size();
+        return std::string_view(dst, s.size());
+    }
+
+private:
+    static constexpr size_t kChunkSize = 1 << 20;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    size_t used = 0;
+};
+
+// ---------- Course-number index ----------
+
+// Open-addressing hash index from course-number text to interned id. Slots
+// live in one flat power-of-two array and probing is linear, so a lookup is
+// one hash plus a short contiguous scan instead of the bucket-node pointer
+// chasing of unordered_map. A slot is just {id, cached hash}: the key bytes
+// themselves are reached through the interning pool, which keeps slots at
+// 8 bytes and lets the cached hash short-circuit almost every compare. The
+// pool is passed in by the owning Catalog rather than stored here.
+class CourseNumberIndex {
+public:
+    CourseId find(std::string_view key, const std::vector<std::string_view>& pool) const {
+        if (slots.empty()) return kNoCourseIndex;
+        uint32_t h = hashKey(key);
+        size_t mask = slots.size() - 1;
+        uint64_t steps = 0;
+        CourseId found = kNoCourseIndex;
+        for (size_t i = h & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots[i];
+            steps++;
+            if (slot.id == kEmptySlot) break;
+            if (slot.hash == h && pool[slot.id] == key) {
+                found = slot.id;
+                break;
+            }
+        }
+        PerfStats& stats = localPerfStats();
+        bumpCounter(stats.probeCount, 1);
+        bumpCounter(stats.probeSteps, steps);
+        if (steps > stats.probeMax.load(std::memory_order_relaxed)) {
+            stats.probeMax.store(steps, std::memory_order_relaxed);
+        }
+        return found;
+    }
+
+    // Key must not already be present; the caller probes first via find().
+    void insert(CourseId id, std::string_view key, const std::vector<std::string_view>& pool) {
+        if ((count + 1) * 10 >= slots.size() * 7) { // grow at 70% load
+            grow(pool);
+        }
+        place(hashKey(key), id);
+        count++;
+    }
+
+    void reserve(size_t n, const std::vector<std::string_view>& pool) {
+        size_t needed = 16;
+        while (needed * 7 < n * 10) needed <<= 1;
+        if (needed > slots.size()) rehash(needed, pool);
+    }
+
+private:
+    static constexpr CourseId kEmptySlot = 0xFFFFFFFFu;
+
+    struct Slot {
+        CourseId id = kEmptySlot;
+        uint32_t hash = 0;
+    };
+
+    // FNV-1a: course numbers are short, so a byte-at-a-time hash beats setup
+    // costs of anything fancier.
+    static uint32_t hashKey(std::string_view key) {
+        uint32_t h = 2166136261u;
+        for (char c : key) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    void place(uint32_t h, CourseId id) {
+        size_t mask = slots.size() - 1;
+        size_t i = h & mask;
+        while (slots[i].id != kEmptySlot) i = (i + 1) & mask;
+        slots[i].id = id;
+        slots[i].hash = h;
+    }
+
+    void grow(const std::vector<std::string_view>& pool) {
+        rehash(slots.empty() ? 16 : slots.size() * 2, pool);
+    }
+
+    void rehash(size_t newSize, const std::vector<std::string_view>&) {
+        std::vector<Slot> old = std::move(slots);
+        slots.assign(newSize, Slot());
+        for (const Slot& s : old) {
+            if (s.id != kEmptySlot) place(s.hash, s.id);
+        }
+    }
+
+    std::vector<Slot> slots;
+    size_t count = 0;
+};
+
+// ---------- Core-curriculum fast path ----------
+
+// The core curriculum is fixed at build time and takes the overwhelming share
+// of option-3 lookups, so those numbers get a perfect-hash table computed by
+// the compiler: one seeded hash, one slot read, one string compare, never a
+// probe chain. The list below mirrors the current ABCU core; deployments
+// regenerate it from the registrar's core-curriculum export at build time.
+// Numbers must already be in normalized (trimmed, upper-case) form.
+static constexpr const char* kCoreCourseNumbers[] = {
+    "CSCI100", "CSCI101", "CSCI150", "CSCI200", "CSCI250", "CSCI300",
+    "CSCI301", "CSCI350", "CSCI400", "MATH101", "MATH201", "MATH301",
+    "ENGL101", "ENGL102", "HUMN100", "PHYS201", "BIOL101", "CHEM101",
+    "PSYC101", "HIST101", "ECON201", "COMM120", "IT145",   "IT200",
+};
+static constexpr uint32_t kCoreCount =
+    sizeof(kCoreCourseNumbers) / sizeof(kCoreCourseNumbers[0]);
+static constexpr uint8_t kCoreEmptySlot = 0xFF; // kCoreCount must stay < 255
+
+static constexpr size_t coreSlotCountFor(uint32_t n) {
+    size_t slots = 16;
+    while (slots < n * 2) slots <<= 1; // <=50% load keeps the seed search short
+    return slots;
+}
+static constexpr size_t kCoreSlotCount = coreSlotCountFor(kCoreCount);
+
+// Seeded FNV-1a; findCoreSeed() below searches for a seed that maps the core
+// set into kCoreSlotCount slots with no collisions. The final shift-xor folds
+// the high bits down: FNV's low k bits depend only on the low k bits of the
+// seed (multiplying by an odd constant mod 2^k), so without it the masked
+// slot would see just kCoreSlotCount distinct seeds and the search could
+// never terminate.
+static constexpr uint32_t coreHash(const char* s, uint32_t seed) {
+    uint32_t h = seed;
+    for (; *s != '\0'; s++) {
+        h ^= static_cast<unsigned char>(*s);
+        h *= 16777619u;
+    }
+    return h ^ (h >> 16);
+}
+
+static constexpr bool coreSeedIsPerfect(uint32_t seed) {
+    bool used[kCoreSlotCount] = {};
+    for (uint32_t i = 0; i < kCoreCount; i++) {
+        size_t slot = coreHash(kCoreCourseNumbers[i], seed) & (kCoreSlotCount - 1);
+        if (used[slot]) return false;
+        used[slot] = true;
+    }
+    return true;
+}
+
+static constexpr uint32_t findCoreSeed() {
+    uint32_t seed = 2166136261u;
+    while (!coreSeedIsPerfect(seed)) seed++;
+    return seed;
+}
+static constexpr uint32_t kCoreSeed = findCoreSeed();
+
+// slot -> index into kCoreCourseNumbers, or kCoreEmptySlot.
+struct CoreSlotTable {
+    uint8_t entry[kCoreSlotCount] = {};
+};
+
+static constexpr CoreSlotTable buildCoreSlotTable() {
+    CoreSlotTable table{};
+    for (size_t s = 0; s < kCoreSlotCount; s++) table.entry[s] = kCoreEmptySlot;
+    for (uint32_t i = 0; i < kCoreCount; i++) {
+        size_t slot = coreHash(kCoreCourseNumbers[i], kCoreSeed) & (kCoreSlotCount - 1);
+        table.entry[slot] = static_cast<uint8_t>(i);
+    }
+    return table;
+}
+static constexpr CoreSlotTable kCoreSlotTable = buildCoreSlotTable();
+
+// Runtime twin of the constexpr hash, same seed.
+static inline uint32_t coreHash(std::string_view s) {
+    uint32_t h = kCoreSeed;
+    for (char c : s) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h ^ (h >> 16);
+}
+
+// ---------- Catalog ----------
+
+// The loaded catalog: an interning pool of course-number strings, the course
+// records themselves, and a side index from interned id to course record.
+// Prerequisite resolution is an array index (id -> courseIndexOfId -> courses),
+// not a string hash probe. An id with no record (a prerequisite whose own row
+// was skipped) maps to kNoCourseIndex.
+struct Catalog {
+    // The arena is held through a shared_ptr so a later generation that
+    // aliases this one's text can pin just the bytes, not the whole catalog.
+    std::shared_ptr<StringArena> arena = std::make_shared<StringArena>();
+    std::vector<std::string_view> numberPool;      // id -> course number text
+    CourseNumberIndex numberIds;                   // number text -> id, flat open addressing
+    std::vector<Course> courses;
+    std::vector<uint32_t> courseIndexOfId;         // id -> index into courses
+    std::vector<uint32_t> sortedCourses;           // course indices, sorted by number text
+    std::vector<std::string_view> listNumbers;     // hot listing columns in sorted order:
+    std::vector<std::string_view> listTitles;      //   parallel (number, title) arrays
+    std::vector<std::vector<uint32_t>> dependentsOfId; // prereq id -> dependent course indices
+    std::vector<CourseId> coreIds;                 // core-table index -> this generation's id
+    std::unordered_map<std::string, std::vector<uint32_t>> titleWords; // keyword -> course indices
+    std::vector<uint64_t> numberBloom;             // bloom bits over interned numbers
+    std::vector<std::shared_ptr<const StringArena>> pinnedArenas; // aliased generations' bytes
+    std::shared_ptr<const Catalog> sharedTextBase; // text base; load-time only
+    std::vector<uint32_t> chainDepth;              // course index -> longest prereq chain
+    std::unordered_map<std::string_view, std::string_view> baseTitleText; // load-time only
+
+    // Views point into the arena, so catalogs move but never copy.
+    Catalog() = default;
+    Catalog(const Catalog&) = delete;
+    Catalog& operator=(const Catalog&) = delete;
+    Catalog(Catalog&&) = default;
+    Catalog& operator=(Catalog&&) = default;
+
+    // Marks a sibling generation (typically last term's catalog) as the text
+    // base for this load: numbers and titles whose bytes already exist there
+    // are aliased instead of copied. What gets pinned for the aliased bytes'
+    // lifetime is only the base's arena chain (its own arena plus whatever it
+    // aliased in turn), never the base catalog itself -- its indexes, records,
+    // and caches stay free to die when the base is replaced. The catalog
+    // pointer and title lookup are load-time scaffolding; finalizeIndexes()
+    // drops both.
+    void shareTextWith(std::shared_ptr<const Catalog> base) {
+        if (base == nullptr || base->empty()) return;
+        sharedTextBase = std::move(base);
+        pinnedArenas = sharedTextBase->pinnedArenas;
+        pinnedArenas.push_back(sharedTextBase->arena);
+        baseTitleText.reserve(sharedTextBase->courses.size());
+        for (const Course& c : sharedTextBase->courses) {
+            baseTitleText.emplace(c.title, c.title);
+        }
+    }
+
+    // Returns the id for a course number, assigning the next dense id (and
+    // copying the text into the arena once) on first sight. With a text base
+    // set, numbers the base already interned are aliased, not copied.
+    CourseId internNumber(std::string_view number) {
+        CourseId existing = numberIds.find(number, numberPool);
+        if (existing != kNoCourseIndex) return existing;
+        CourseId id = static_cast<CourseId>(numberPool.size());
+        std::string_view stored;
+        if (sharedTextBase != nullptr) {
+            CourseId baseId =
+                sharedTextBase->numberIds.find(number, sharedTextBase->numberPool);
+            if (baseId != kNoCourseIndex) stored = sharedTextBase->numberPool[baseId];
+        }
+        if (stored.empty()) stored = arena->store(number);
+        numberPool.push_back(stored);
+        courseIndexOfId.push_back(kNoCourseIndex);
+        numberIds.insert(id, stored, numberPool);
+        return id;
+    }
+
+    // Copies a title into the arena (aliasing the text base's bytes when the
+    // title is unchanged from that generation); titles are not otherwise
+    // deduplicated.
+    std::string_view storeTitle(std::string_view title) {
+        if (sharedTextBase != nullptr) {
+            auto it = baseTitleText.find(title);
+            if (it != baseTitleText.end()) return it->second;
+        }
+        return arena->store(title);
+    }
+
+    std::string_view numberText(CourseId id) const { return numberPool[id]; }
+
+    const Course* courseForId(CourseId id) const {
+        uint32_t idx = courseIndexOfId[id];
+        return idx == kNoCourseIndex ? nullptr : &courses[idx];
+    }
+
+    // Two-hash bloom filter over every interned course number. A third of
+    // real queries are typos; the filter rejects a definite miss after two
+    // cache-resident word reads, so misses never drag the big index table
+    // through the cache. ~16 bits per key with two probes keeps the false
+    // positive rate near 1%, and a false positive just falls through to the
+    // ordinary probe.
+    static uint32_t bloomHash(std::string_view s) {
+        uint32_t h = 2166136261u;
+        for (char c : s) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 16777619u;
+        }
+        return h ^ (h >> 16); // fold high bits; see coreHash
+    }
+
+    void bloomSet(uint32_t h) {
+        size_t bit = h & (numberBloom.size() * 64 - 1);
+        numberBloom[bit >> 6] |= uint64_t(1) << (bit & 63);
+    }
+
+    bool bloomTest(uint32_t h) const {
+        size_t bit = h & (numberBloom.size() * 64 - 1);
+        return (numberBloom[bit >> 6] >> (bit & 63)) & 1;
+    }
+
+    void buildNumberBloom() {
+        size_t words = 1;
+        while (words * 64 < numberPool.size() * 16) words <<= 1; // power of two
+        numberBloom.assign(words, 0);
+        for (std::string_view number : numberPool) {
+            uint32_t h = bloomHash(number);
+            bloomSet(h);
+            bloomSet(h * 2654435761u); // second probe: Knuth multiplicative remix
+        }
+    }
+
+    // Lookup by already-normalized course number.
+    const Course* findCourse(std::string_view number) const {
+        // Core fast path: the compile-time perfect hash answers hot lookups
+        // with one slot read and one compare. coreIds is empty until
+        // finalizeIndexes() runs, so unfinished catalogs skip it.
+        if (!coreIds.empty()) {
+            size_t slot = coreHash(number) & (kCoreSlotCount - 1);
+            uint8_t core = kCoreSlotTable.entry[slot];
+            if (core != kCoreEmptySlot && number == kCoreCourseNumbers[core]) {
+                CourseId id = coreIds[core];
+                return id == kNoCourseIndex ? nullptr : courseForId(id);
+            }
+        }
+        if (!numberBloom.empty()) {
+            uint32_t h = bloomHash(number);
+            if (!bloomTest(h) || !bloomTest(h * 2654435761u)) {
+                bumpCounter(localPerfStats().bloomRejects, 1);
+                return nullptr; // definite miss, skip the index probe
+            }
+        }
+        CourseId id = numberIds.find(number, numberPool);
+        if (id == kNoCourseIndex) return nullptr;
+        return courseForId(id);
+    }
+
+    bool empty() const { return courses.empty(); }
+    size_t size() const { return courses.size(); }
+
+    // Builds the persistent sorted index. Loaders call this once after the
+    // table is final; option 2 then just walks the index, so repeated listings
+    // cost O(n) output instead of a key copy plus O(n log n) sort every time.
+    void buildSortedIndex() {
+        sortedCourses.resize(courses.size());
+        for (uint32_t i = 0; i < courses.size(); i++) sortedCourses[i] = i;
+        std::sort(sortedCourses.begin(), sortedCourses.end(),
+            [this](uint32_t a, uint32_t b) {
+                return numberText(courses[a].number) < numberText(courses[b].number);
+            });
+
+        // Hot/cold split for the listing path: the full-catalog listing only
+        // needs numbers and titles, so they get their own dense arrays in
+        // sorted order and a listing never drags each Course's prerequisite
+        // vector (cold data) through the cache.
+        listNumbers.resize(courses.size());
+        listTitles.resize(courses.size());
+        for (uint32_t i = 0; i < sortedCourses.size(); i++) {
+            const Course& c = courses[sortedCourses[i]];
+            listNumbers[i] = numberText(c.number);
+            listTitles[i] = c.title;
+        }
+    }
+
+    // Builds the reverse-dependency index: for each interned id, the course
+    // records that list it as a direct prerequisite. Answers "what requires X"
+    // with one array index plus a short list walk instead of scanning every
+    // prerequisite edge in the table.
+    void buildDependentsIndex() {
+        dependentsOfId.assign(numberPool.size(), {});
+        for (uint32_t i = 0; i < courses.size(); i++) {
+            for (CourseId pid : courses[i].prerequisites) {
+                dependentsOfId[pid].push_back(i);
+            }
+        }
+    }
+
+    // Builds the inverted title index: each upper-cased word of every title
+    // maps to the courses whose titles contain it, so keyword search costs a
+    // hash probe per query word plus a walk of the matching postings instead
+    // of a scan of every title in the catalog. Postings are in course-index
+    // order by construction.
+    void buildTitleIndex() {
+        titleWords.clear();
+        std::string word;
+        for (uint32_t i = 0; i < courses.size(); i++) {
+            std::string_view title = courses[i].title;
+            for (size_t pos = 0; pos <= title.size(); pos++) {
+                char c = pos < title.size() ? title[pos] : ' ';
+                if (std::isalnum(static_cast<unsigned char>(c))) {
+                    word += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                    continue;
+                }
+                if (!word.empty()) {
+                    std::vector<uint32_t>& postings = titleWords[word];
+                    if (postings.empty() || postings.back() != i) {
+                        postings.push_back(i);
+                    }
+                    word.clear();
+                }
+            }
+        }
+    }
+
+    // Resolves the compile-time core table against this generation's ids so
+    // the fast path ends in an array read instead of a dynamic probe.
+    void buildCoreFastPath() {
+        coreIds.assign(kCoreCount, kNoCourseIndex);
+        for (uint32_t i = 0; i < kCoreCount; i++) {
+            coreIds[i] = numberIds.find(kCoreCourseNumbers[i], numberPool);
+        }
+    }
+
+    // Longest-chain depths over the prerequisite DAG: a course with no
+    // prerequisites has depth 0, and every prerequisite link adds one (a link
+    // to a number with no record still counts as one level). Bottom-up with
+    // an explicit stack; `state` is 0 unvisited / 1 in progress / 2 done, and
+    // entries pre-marked done keep their chainDepth value, which is how the
+    // delta path trusts carried-forward depths. A back edge met mid-walk
+    // counts as a single level, the same as a link to a missing record, and
+    // is not followed further, so cycles terminate like they do in
+    // prereqClosure().
+    void computeChainDepths(std::vector<uint8_t>& state) {
+        std::vector<uint32_t> stack;
+        for (uint32_t root = 0; root < courses.size(); root++) {
+            if (state[root] == 2) continue;
+            stack.push_back(root);
+            while (!stack.empty()) {
+                uint32_t idx = stack.back();
+                if (state[idx] == 2) {
+                    stack.pop_back();
+                    continue;
+                }
+                if (state[idx] == 0) {
+                    state[idx] = 1;
+                    bool ready = true;
+                    for (CourseId pid : courses[idx].prerequisites) {
+                        uint32_t p = courseIndexOfId[pid];
+                        if (p != kNoCourseIndex && state[p] == 0) {
+                            stack.push_back(p);
+                            ready = false;
+                        }
+                    }
+                    if (!ready) continue; // finish the children first
+                }
+                uint32_t depth = 0;
+                for (CourseId pid : courses[idx].prerequisites) {
+                    uint32_t p = courseIndexOfId[pid];
+                    uint32_t link = 1; // missing record or cycle edge: one level
+                    if (p != kNoCourseIndex && state[p] == 2) {
+                        link = 1 + chainDepth[p];
+                    }
+                    if (link > depth) depth = link;
+                }
+                chainDepth[idx] = depth;
+                state[idx] = 2;
+                stack.pop_back();
+            }
+        }
+    }
+
+    void buildMetrics() {
+        chainDepth.assign(courses.size(), 0);
+        std::vector<uint8_t> state(courses.size(), 0);
+        computeChainDepths(state);
+    }
+
+    // Everything finalizeIndexes() rebuilds except the metrics pass.
+    void rebuildIndexes() {
+        buildSortedIndex();
+        buildDependentsIndex();
+        buildCoreFastPath();
+        buildTitleIndex();
+        buildNumberBloom();
+        baseTitleText.clear(); // load-time scaffolding only
+        baseTitleText.rehash(0);
+        sharedTextBase.reset(); // keep only the arena pins, not the catalog
+    }
+
+    // One-stop index rebuild for loaders once the course set is final.
+    void finalizeIndexes() {
+        rebuildIndexes();
+        buildMetrics();
+    }
+
+    // Delta variant: indexes are rebuilt as usual, but chain depths are only
+    // recomputed for the dirty set -- the touched courses plus everything
+    // downstream of them through the reverse-dependency index -- and carried
+    // forward from the base generation for every course outside that cone.
+    void finalizeIndexesAfterDelta(const Catalog& base,
+        const std::unordered_set<std::string_view>& touchedNumbers) {
+        rebuildIndexes();
+
+        // Propagate dirtiness upward from the touched numbers.
+        std::vector<char> dirtyCourse(courses.size(), 0);
+        std::vector<char> idSeen(numberPool.size(), 0);
+        std::vector<CourseId> queue;
+        for (std::string_view number : touchedNumbers) {
+            CourseId id = numberIds.find(number, numberPool);
+            if (id == kNoCourseIndex || idSeen[id]) continue;
+            idSeen[id] = 1;
+            uint32_t idx = courseIndexOfId[id];
+            if (idx != kNoCourseIndex) dirtyCourse[idx] = 1;
+            queue.push_back(id);
+        }
+        while (!queue.empty()) {
+            CourseId id = queue.back();
+            queue.pop_back();
+            for (uint32_t dep : dependentsOfId[id]) {
+                if (dirtyCourse[dep]) continue;
+                dirtyCourse[dep] = 1;
+                CourseId depId = courses[dep].number;
+                if (!idSeen[depId]) {
+                    idSeen[depId] = 1;
+                    queue.push_back(depId);
+                }
+            }
+        }
+
+        // Clean courses keep the base generation's depth; anything the base
+        // does not know about stays dirty and gets recomputed.
+        chainDepth.assign(courses.size(), 0);
+        std::vector<uint8_t> state(courses.size(), 0);
+        for (uint32_t i = 0; i < courses.size(); i++) {
+            if (dirtyCourse[i]) continue;
+            CourseId baseId =
+                base.numberIds.find(numberText(courses[i].number), base.numberPool);
+            if (baseId == kNoCourseIndex) continue;
+            uint32_t baseIdx = base.courseIndexOfId[baseId];
+            if (baseIdx == kNoCourseIndex) continue;
+            chainDepth[i] = base.chainDepth[baseIdx];
+            state[i] = 2;
+        }
+        computeChainDepths(state);
+    }
+
+    // Full transitive prerequisite closure for one course record, memoized per
+    // course so repeated audits touching the same core courses are answered
+    // from the cache. Closures are computed bottom-up with an explicit stack
+    // (deep chains must not recurse) and are sorted/deduplicated id sets.
+    const std::vector<CourseId>& prereqClosure(uint32_t courseIndex) const {
+        // Memoization is the one mutation behind the const query surface, so
+        // it takes a lock; finished entries are never touched again and the
+        // cache vector never reallocates after sizing, so returned references
+        // stay valid for concurrent readers.
+        std::lock_guard<std::mutex> guard(*closureLock);
+        if (closureCache.size() != courses.size()) {
+            closureCache.assign(courses.size(), {});
+            closureState.assign(courses.size(), kClosureEmpty);
+        }
+        if (closureState[courseIndex] == kClosureDone) {
+            return closureCache[courseIndex];
+        }
+
+        std::vector<uint32_t> stack;
+        stack.push_back(courseIndex);
+        while (!stack.empty()) {
+            uint32_t cur = stack.back();
+            if (closureState[cur] == kClosureDone) {
+                stack.pop_back();
+                continue;
+            }
+            if (closureState[cur] == kClosureEmpty) {
+                // First touch: queue unresolved children, finalize on revisit.
+                closureState[cur] = kClosureInProgress;
+                for (CourseId pid : courses[cur].prerequisites) {
+                    uint32_t pidx = courseIndexOfId[pid];
+                    if (pidx != kNoCourseIndex && closureState[pidx] == kClosureEmpty) {
+                        stack.push_back(pidx);
+                    }
+                }
+                continue;
+            }
+            // Children resolved (or cyclic): merge direct prereqs plus child closures.
+            std::vector<CourseId> acc;
+            for (CourseId pid : courses[cur].prerequisites) {
+                acc.push_back(pid);
+                uint32_t pidx = courseIndexOfId[pid];
+                // A child still in progress sits below us in a prerequisite
+                // cycle; it contributes its direct id only.
+                if (pidx != kNoCourseIndex && closureState[pidx] == kClosureDone) {
+                    const auto& sub = closureCache[pidx];
+                    acc.insert(acc.end(), sub.begin(), sub.end());
+                }
+            }
+            std::sort(acc.begin(), acc.end());
+            acc.erase(std::unique(acc.begin(), acc.end()), acc.end());
+            closureCache[cur] = std::move(acc);
+            closureState[cur] = kClosureDone;
+            stack.pop_back();
+        }
+        return closureCache[courseIndex];
+    }
+
+private:
+    enum : uint8_t { kClosureEmpty = 0, kClosureInProgress = 1, kClosureDone = 2 };
+    mutable std::vector<std::vector<CourseId>> closureCache;
+    mutable std::vector<uint8_t> closureState;
+    // Held by pointer so the Catalog stays movable.
+    mutable std::unique_ptr<std::mutex> closureLock = std::make_unique<std::mutex>();
+};
+
+// ---------- Catalog generations ----------
+
+// Publication point for immutable catalog generations. A load builds its
+// Catalog entirely off to the side and publishes it here with an atomic
+// pointer swap (RCU-style); readers snapshot the pointer once per query and
+// run lock-free against that generation, which stays alive until the last
+// reader drops its shared_ptr even if a reload swaps in a newer one.
+class CatalogStore {
+public:
+    CatalogStore() { publish(Catalog()); }
+
+    std::shared_ptr<const Catalog> current() const {
+        return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+    }
+
+    void publish(Catalog&& next) {
+        publish(std::make_shared<const Catalog>(std::move(next)));
+    }
+
+    void publish(std::shared_ptr<const Catalog> fresh) {
+        std::atomic_store_explicit(&current_, std::move(fresh), std::memory_order_release);
+    }
+
+private:
+    std::shared_ptr<const Catalog> current_;
+};
+
+// Named catalog generations for multi-term deployments: several terms stay
+// resident in one process, one of them active, and loads into a new term
+// alias unchanged string bytes from the previously loaded one (see
+// Catalog::shareTextWith). Queries go through the same lock-free CatalogStore
+// publication point; selecting a term is just another publish.
+class CatalogRegistry {
+public:
+    std::shared_ptr<const Catalog> current() const { return store.current(); }
+
+    const std::string& activeName() const { return active; }
+
+    void select(const std::string& name) {
+        active = name;
+        auto it = byName.find(name);
+        store.publish(it == byName.end() ? std::make_shared<const Catalog>()
+                                         : it->second);
+    }
+
+    void publish(Catalog&& next) {
+        std::shared_ptr<const Catalog> fresh =
+            std::make_shared<const Catalog>(std::move(next));
+        byName[active] = fresh;
+        lastPublished = fresh;
+        lastPublishedName = active;
+        store.publish(std::move(fresh));
+    }
+
+    // Text base for a load into `name`: the most recently published other
+    // term. Reloads of the same term share nothing, so dropped generations
+    // are not pinned by their own replacements.
+    std::shared_ptr<const Catalog> shareBaseFor(const std::string& name) const {
+        if (!lastPublishedName.empty() && lastPublishedName != name) {
+            return lastPublished;
+        }
+        return nullptr;
+    }
+
+    void appendList(std::string& out) const {
+        if (byName.empty()) {
+            out += "No catalogs loaded.\n";
+            return;
+        }
+        for (const auto& entry : byName) {
+            out += entry.first == active ? "* " : "  ";
+            out += entry.first;
+            out += " (";
+            out += std::to_string(entry.second->size());
+            out += " courses)\n";
+        }
+    }
+
+private:
+    CatalogStore store;
+    std::map<std::string, std::shared_ptr<const Catalog>> byName;
+    std::string active = "default";
+    std::shared_ptr<const Catalog> lastPublished;
+    std::string lastPublishedName;
+};
+
+// ---------- Core program functions ----------
+
+// A parsed row that passed format checks but has not had its prerequisites
+// validated yet. Validation is deferred until the whole file has been read.
+// Fields are views into the mapped file (or into the owning shard's
+// ownedText for the rare token that needed rewriting); nothing is copied
+// until the merge phase interns the survivors into the shared pool. During
+// parallel parsing lineNumber is relative to the worker's chunk and is fixed
+// up to an absolute line number at merge time.
+struct PendingCourse {
+    int lineNumber = 0;
+    std::string_view courseNumber;
+    std::string_view title;
+    std::vector<std::string_view> prerequisites;
+};
+
+// A format error found by a parse worker. Reporting is deferred to the merge
+// phase, where the chunk-relative line number becomes absolute.
+struct ParseDiagnostic {
+    enum Kind { BadFormat, MissingFields };
+    int lineNumber = 0; // chunk-relative
+    Kind kind = BadFormat;
+};
+
+// Output of one parse worker over one byte range of the file.
+struct ParseShard {
+    std::vector<PendingCourse> pending;
+    std::vector<ParseDiagnostic> diagnostics;
+    std::list<std::string> ownedText; // backs the rare rewritten tokens
+    int lineCount = 0;
+};
+
+// Parses one chunk (whole lines only) into a private shard. Runs on a worker
+// thread; touches nothing shared. Duplicate detection is left to the merge
+// phase since it needs a global, file-ordered view.
+static ParseShard parseChunk(std::string_view contents) {
+    ParseShard shard;
+    std::vector<std::string_view> tokens;
+    size_t pos = 0;
+    while (pos < contents.size()) {
+        size_t nl = findByte(contents, '\n', pos);
+        std::string_view line = (nl == std::string_view::npos)
+            ? contents.substr(pos)
+            : contents.substr(pos, nl - pos);
+        pos = (nl == std::string_view::npos) ? contents.size() : nl + 1;
+        shard.lineCount++;
+
+        // Strip a trailing CR so Windows-style files parse the same way.
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        if (trimView(line).empty()) {
+            continue; // skip empty lines
+        }
+
+        splitByComma(line, tokens);
+
+        // Must have at least courseNumber + title
+        if (tokens.size() < 2) {
+            shard.diagnostics.push_back({ shard.lineCount, ParseDiagnostic::BadFormat });
+            continue;
+        }
+
+        std::string_view courseNum = normalizeCourseNumber(tokens[0], shard.ownedText);
+        std::string_view title = tokens[1]; // already trimmed by splitByComma
+
+        if (courseNum.empty() || title.empty()) {
+            shard.diagnostics.push_back({ shard.lineCount, ParseDiagnostic::MissingFields });
+            continue;
+        }
+
+        PendingCourse pc;
+        pc.lineNumber = shard.lineCount;
+        pc.courseNumber = courseNum;
+        pc.title = title;
+        for (size_t i = 2; i < tokens.size(); i++) {
+            std::string_view prereq = normalizeCourseNumber(tokens[i], shard.ownedText);
+            // Ignore blank prereq tokens (treat as no prerequisite)
+            if (!prereq.empty()) {
+                pc.prerequisites.push_back(prereq);
+            }
+        }
+        shard.pending.push_back(std::move(pc));
+    }
+    return shard;
+}
+
+// Thread-count knob: ABCU_LOAD_THREADS beats the config-file value, which
+// beats hardware_concurrency(). The config override is set once at startup.
+static unsigned configLoadThreads = 0;
+
+static unsigned loadThreadCount() {
+    if (const char* env = std::getenv("ABCU_LOAD_THREADS")) {
+        int n = std::atoi(env);
+        if (n > 0) return static_cast<unsigned>(n);
+    }
+    if (configLoadThreads > 0) return configLoadThreads;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+static Catalog loadCoursesFromFile(const std::string& fileName,
+    std::shared_ptr<const Catalog> shareFrom = nullptr) {
+    ScopedLatency timed(localPerfStats().loadLatency);
+    Catalog catalog;
+    catalog.shareTextWith(std::move(shareFrom));
+    // Keys are views into the mapped file / shard-owned text, both of which
+    // outlive this function's insert phase; no number is copied to dedup it.
+    std::unordered_set<std::string_view> allCourseNumbers;
+    std::vector<PendingCourse> pending;
+
+    MappedFile file(fileName);
+    if (!file.ok) {
+        std::cerr << "ERROR: Could not open file: " << fileName << "\n";
+        return catalog;
+    }
+
+    std::string_view contents = file.view();
+
+    // ----- Chunk the file on line boundaries and parse chunks in parallel -----
+    // Each worker parses a byte range into a private shard; nothing is shared
+    // until the merge below. Small files stay on a single chunk.
+    unsigned threadCount = loadThreadCount();
+    constexpr size_t kMinBytesPerChunk = 1 << 20; // not worth spawning threads below this
+    if (threadCount > 1 && contents.size() / kMinBytesPerChunk < threadCount) {
+        size_t fit = contents.size() / kMinBytesPerChunk;
+        threadCount = fit > 1 ? static_cast<unsigned>(fit) : 1;
+    }
+
+    std::vector<std::string_view> chunks;
+    {
+        size_t begin = 0;
+        for (unsigned i = 0; i < threadCount && begin < contents.size(); i++) {
+            size_t target = (i + 1 == threadCount)
+                ? contents.size()
+                : begin + (contents.size() - begin) / (threadCount - i);
+            // Advance to the next newline so every chunk holds whole lines.
+            size_t end = (target >= contents.size())
+                ? contents.size()
+                : contents.find('\n', target);
+            end = (end == std::string_view::npos) ? contents.size() : end + 1;
+            chunks.push_back(contents.substr(begin, end - begin));
+            begin = end;
+        }
+    }
+
+    // ----- Pipelined parse and merge -----
+    // Workers parse chunks into private shards and hand each finished shard to
+    // this thread through an in-order ready rendezvous, so the serial merge
+    // (line-number fix-up, deferred error reporting, duplicate detection)
+    // overlaps the parsing of later chunks instead of waiting for a full join.
+    // With the kernel readahead above, I/O, parse, and merge/validate all run
+    // concurrently. First occurrence still wins on duplicates, exactly as a
+    // sequential read would order them.
+    std::vector<ParseShard> shards(chunks.size());
+    std::vector<char> shardReady(chunks.size(), 0);
+    std::mutex shardMutex;
+    std::condition_variable shardCv;
+    std::vector<std::thread> workers;
+    if (chunks.size() <= 1) {
+        if (!chunks.empty()) {
+            shards[0] = parseChunk(chunks[0]);
+            shardReady[0] = 1;
+        }
+    }
+    else {
+        workers.reserve(chunks.size());
+        for (size_t i = 0; i < chunks.size(); i++) {
+            workers.emplace_back([&, i]() {
+                ParseShard shard = parseChunk(chunks[i]);
+                {
+                    std::lock_guard<std::mutex> lock(shardMutex);
+                    shards[i] = std::move(shard);
+                    shardReady[i] = 1;
+                }
+                shardCv.notify_all();
+            });
+        }
+    }
+
+    {
+        int lineBase = 0;
+        for (size_t s = 0; s < shards.size(); s++) {
+            if (!workers.empty()) {
+                std::unique_lock<std::mutex> lock(shardMutex);
+                shardCv.wait(lock, [&]() { return shardReady[s] != 0; });
+            }
+            ParseShard& shard = shards[s];
+            size_t d = 0, p = 0;
+            while (d < shard.diagnostics.size() || p < shard.pending.size()) {
+                bool takeDiag = d < shard.diagnostics.size()
+                    && (p >= shard.pending.size()
+                        || shard.diagnostics[d].lineNumber < shard.pending[p].lineNumber);
+                if (takeDiag) {
+                    const auto& diag = shard.diagnostics[d++];
+                    int lineNumber = lineBase + diag.lineNumber;
+                    if (diag.kind == ParseDiagnostic::BadFormat) {
+                        std::cerr << "ERROR: Bad format on line " << lineNumber
+                            << " (skipping line)\n";
+                    }
+                    else {
+                        std::cerr << "ERROR: Missing courseNumber/title on line " << lineNumber
+                            << " (skipping line)\n";
+                    }
+                }
+                else {
+                    PendingCourse& pc = shard.pending[p++];
+                    pc.lineNumber += lineBase;
+                    if (allCourseNumbers.find(pc.courseNumber) != allCourseNumbers.end()) {
+                        std::cerr << "ERROR: Duplicate courseNumber '" << pc.courseNumber
+                            << "' on line " << pc.lineNumber << " (skipping line)\n";
+                        continue;
+                    }
+                    allCourseNumbers.insert(pc.courseNumber);
+                    pending.push_back(std::move(pc));
+                }
+            }
+            lineBase += shard.lineCount;
+        }
+    }
+
+    for (auto& w : workers) w.join();
+
+    // ----- Fix-up phase: validate prereqs against the full ID set, insert survivors -----
+    // Note: validation is against every course number seen in the file (same as the
+    // old pass-1 set), so a course may reference a prereq that itself gets skipped;
+    // such a prereq still gets an interned id but no course record behind it.
+    for (auto& pc : pending) {
+        bool prereqIsValid = true;
+        for (const auto& prereq : pc.prerequisites) {
+            if (allCourseNumbers.find(prereq) == allCourseNumbers.end()) {
+                std::cerr << "ERROR: Line " << pc.lineNumber << " invalid prerequisite '" << prereq
+                    << "' for course '" << pc.courseNumber << "' (skipping course)\n";
+                prereqIsValid = false;
+                break;
+            }
+        }
+
+        if (!prereqIsValid) {
+            continue; // IMPORTANT: do not insert this course
+        }
+
+        // Intern and insert (duplicates were already skipped during the merge,
+        // but we guard anyway by skipping if a record is already present)
+        CourseId id = catalog.internNumber(pc.courseNumber);
+        if (catalog.courseIndexOfId[id] != kNoCourseIndex) {
+            continue;
+        }
+        catalog.courseIndexOfId[id] = static_cast<uint32_t>(catalog.courses.size());
+        Course& c = catalog.courses.emplace_back();
+        c.number = id;
+        c.title = catalog.storeTitle(pc.title);
+        c.prerequisites.reserve(pc.prerequisites.size());
+        for (const auto& prereq : pc.prerequisites) {
+            c.prerequisites.push_back(catalog.internNumber(prereq));
+        }
+    }
+
+    catalog.finalizeIndexes();
+    return catalog;
+}
+
+// ---------- Delta load ----------
+
+// Applies a small changes file against an existing generation instead of
+// re-parsing the full catalog. Delta rows use the normal CSV layout and upsert
+// by course number; a line of the form `-CS200` deletes that course. The
+// result is a fresh generation: untouched records are carried forward with a
+// straight copy (no parsing, no re-validation), and only the delta rows
+// themselves are validated, so reload cost is dominated by the delta.
+//
+// A prerequisite is considered valid if its number is known to the base
+// generation or introduced by the delta — the same "known course number"
+// rule the full loader applies. Deleting a course does not invalidate
+// dependents; their links degrade to number-only references, exactly like a
+// skipped row does on a full load.
+//
+// Returns false (leaving `next` untouched) when the delta file cannot be
+// opened, so callers keep the current generation published instead of
+// replacing it with an empty one over a typo'd filename.
+static bool applyDeltaFile(const Catalog& base, const std::string& fileName, Catalog& next) {
+    ScopedLatency timed(localPerfStats().loadLatency);
+
+    MappedFile file(fileName);
+    if (!file.ok) {
+        std::cerr << "ERROR: Could not open file: " << fileName << "\n";
+        return false;
+    }
+
+    // ----- Walk the delta file (sequential; deltas are small by definition) -----
+    std::vector<PendingCourse> upserts;
+    std::list<std::string> ownedText;             // backs rewritten delta tokens
+    std::unordered_set<std::string_view> touched;    // upserted or deleted numbers
+    std::unordered_set<std::string_view> deltaNumbers; // upserted numbers only
+    {
+        std::string_view contents = file.view();
+        std::vector<std::string_view> tokens;
+        int lineNumber = 0;
+        size_t pos = 0;
+        while (pos < contents.size()) {
+            size_t nl = findByte(contents, '\n', pos);
+            std::string_view line = (nl == std::string_view::npos)
+                ? contents.substr(pos)
+                : contents.substr(pos, nl - pos);
+            pos = (nl == std::string_view::npos) ? contents.size() : nl + 1;
+            lineNumber++;
+
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            line = trimView(line);
+            if (line.empty()) {
+                continue;
+            }
+
+            // Deletion marker: -COURSENUMBER
+            if (line[0] == '-') {
+                std::string_view courseNum = normalizeCourseNumber(line.substr(1), ownedText);
+                if (courseNum.empty()) {
+                    std::cerr << "ERROR: Bad format on line " << lineNumber
+                        << " (skipping line)\n";
+                    continue;
+                }
+                if (base.findCourse(courseNum) == nullptr) {
+                    std::cerr << "WARNING: Delete for unknown course '" << courseNum
+                        << "' on line " << lineNumber << " (ignoring)\n";
+                    continue;
+                }
+                if (!touched.insert(courseNum).second) {
+                    std::cerr << "ERROR: Duplicate courseNumber '" << courseNum << "' on line "
+                        << lineNumber << " (skipping line)\n";
+                }
+                continue;
+            }
+
+            splitByComma(line, tokens);
+            if (tokens.size() < 2) {
+                std::cerr << "ERROR: Bad format on line " << lineNumber << " (skipping line)\n";
+                continue;
+            }
+
+            std::string_view courseNum = normalizeCourseNumber(tokens[0], ownedText);
+            std::string_view title = tokens[1];
+            if (courseNum.empty() || title.empty()) {
+                std::cerr << "ERROR: Missing courseNumber/title on line " << lineNumber
+                    << " (skipping line)\n";
+                continue;
+            }
+            if (!touched.insert(courseNum).second) {
+                std::cerr << "ERROR: Duplicate courseNumber '" << courseNum << "' on line "
+                    << lineNumber << " (skipping line)\n";
+                continue;
+            }
+            deltaNumbers.insert(courseNum);
+
+            PendingCourse pc;
+            pc.lineNumber = lineNumber;
+            pc.courseNumber = courseNum;
+            pc.title = title;
+            for (size_t i = 2; i < tokens.size(); i++) {
+                std::string_view prereq = normalizeCourseNumber(tokens[i], ownedText);
+                if (!prereq.empty()) {
+                    pc.prerequisites.push_back(prereq);
+                }
+            }
+            upserts.push_back(std::move(pc));
+        }
+    }
+
+    // ----- Carry forward untouched records (copy, no parse or validation) -----
+    for (const Course& c : base.courses) {
+        std::string_view number = base.numberText(c.number);
+        if (touched.count(number) != 0) {
+            continue; // deleted or about to be re-inserted from the delta
+        }
+        CourseId id = next.internNumber(number);
+        next.courseIndexOfId[id] = static_cast<uint32_t>(next.courses.size());
+        Course& copied = next.courses.emplace_back();
+        copied.number = id;
+        copied.title = next.storeTitle(c.title);
+        copied.prerequisites.reserve(c.prerequisites.size());
+        for (CourseId pid : c.prerequisites) {
+            copied.prerequisites.push_back(next.internNumber(base.numberText(pid)));
+        }
+    }
+
+    // ----- Validate and insert only the delta rows -----
+    auto numberKnown = [&](std::string_view number) {
+        return deltaNumbers.count(number) != 0
+            || base.numberIds.find(number, base.numberPool) != kNoCourseIndex;
+    };
+    for (auto& pc : upserts) {
+        bool prereqIsValid = true;
+        for (const auto& prereq : pc.prerequisites) {
+            if (!numberKnown(prereq)) {
+                std::cerr << "ERROR: Line " << pc.lineNumber << " invalid prerequisite '" << prereq
+                    << "' for course '" << pc.courseNumber << "' (skipping course)\n";
+                prereqIsValid = false;
+                break;
+            }
+        }
+        if (!prereqIsValid) {
+            continue;
+        }
+
+        CourseId id = next.internNumber(pc.courseNumber);
+        if (next.courseIndexOfId[id] != kNoCourseIndex) {
+            continue;
+        }
+        next.courseIndexOfId[id] = static_cast<uint32_t>(next.courses.size());
+        Course& c = next.courses.emplace_back();
+        c.number = id;
+        c.title = next.storeTitle(pc.title);
+        c.prerequisites.reserve(pc.prerequisites.size());
+        for (const auto& prereq : pc.prerequisites) {
+            c.prerequisites.push_back(next.internNumber(prereq));
+        }
+    }
+
+    next.finalizeIndexesAfterDelta(base, touched);
+    return true;
+}
+
+// ---------- Binary snapshot ----------
+//
+// Compact dump of a validated Catalog so advisor sessions can skip the CSV
+// parse entirely. The file mirrors the in-memory model: the interned
+// course-number pool is written once, and prerequisites are interned ids.
+// Layout (all integers little-endian, host-width fixed types):
+//   char     magic[8]   "ABCUSNP2"
+//   uint32   idCount                  entries in the number pool
+//   uint32   courseCount
+//   uint64   poolSize
+//   char     pool[poolSize]           string bytes, each distinct string once
+//   per id, in id order:
+//     uint32 numberOffset, numberLength
+//   per course, in record order:
+//     uint32 numberId
+//     uint32 titleOffset, titleLength
+//     uint32 prereqCount
+//     uint32 prereq[prereqCount]      interned ids
+// Reload rebuilds numberIds/courseIndexOfId but does no parsing, prereq
+// hashing, or re-validation; snapshots are only written from a valid catalog.
+
+static const char kSnapshotMagic[8] = { 'A', 'B', 'C', 'U', 'S', 'N', 'P', '2' };
+
+static bool saveSnapshot(const Catalog& catalog, const std::string& fileName) {
+    // Interned string pool for the file: each distinct string is written once.
+    std::string pool;
+    std::unordered_map<std::string_view, uint32_t> poolOffsets;
+    auto internString = [&](std::string_view s) -> uint32_t {
+        auto it = poolOffsets.find(s);
+        if (it != poolOffsets.end()) return it->second;
+        uint32_t off = static_cast<uint32_t>(pool.size());
+        pool.append(s);
+        poolOffsets[s] = off;
+        return off;
+    };
+
+    std::vector<uint32_t> numberOffsets;
+    numberOffsets.reserve(catalog.numberPool.size());
+    for (const auto& number : catalog.numberPool) {
+        numberOffsets.push_back(internString(number));
+    }
+    std::vector<uint32_t> titleOffsets;
+    titleOffsets.reserve(catalog.courses.size());
+    for (const auto& c : catalog.courses) {
+        titleOffsets.push_back(internString(c.title));
+    }
+
+    std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "ERROR: Could not open snapshot file for writing: " << fileName << "\n";
+        return false;
+    }
+
+    auto writeU32 = [&](uint32_t v) { out.write(reinterpret_cast<const char*>(&v), sizeof v); };
+    out.write(kSnapshotMagic, sizeof kSnapshotMagic);
+    writeU32(static_cast<uint32_t>(catalog.numberPool.size()));
+    writeU32(static_cast<uint32_t>(catalog.courses.size()));
+    uint64_t poolSize = pool.size();
+    out.write(reinterpret_cast<const char*>(&poolSize), sizeof poolSize);
+    out.write(pool.data(), static_cast<std::streamsize>(pool.size()));
+
+    for (size_t i = 0; i < catalog.numberPool.size(); i++) {
+        writeU32(numberOffsets[i]);
+        writeU32(static_cast<uint32_t>(catalog.numberPool[i].size()));
+    }
+
+    for (size_t i = 0; i < catalog.courses.size(); i++) {
+        const Course& c = catalog.courses[i];
+        writeU32(c.number);
+        writeU32(titleOffsets[i]);
+        writeU32(static_cast<uint32_t>(c.title.size()));
+        writeU32(static_cast<uint32_t>(c.prerequisites.size()));
+        for (CourseId prereq : c.prerequisites) {
+            writeU32(prereq);
+        }
+    }
+
+    if (!out.good()) {
+        std::cerr << "ERROR: Failed writing snapshot file: " << fileName << "\n";
+        return false;
+    }
+    return true;
+}
+
+static Catalog loadSnapshot(const std::string& fileName) {
+    ScopedLatency timed(localPerfStats().loadLatency);
+    Catalog catalog;
+
+    // The snapshot is mmapped like the CSV, so reload cost is page faults over
+    // the pool plus index reconstruction — no parsing or validation.
+    MappedFile file(fileName);
+    if (!file.ok) {
+        std::cerr << "ERROR: Could not open snapshot file: " << fileName << "\n";
+        return catalog;
+    }
+
+    const char* p = file.data;
+    size_t remaining = file.size;
+    auto readBytes = [&](void* dst, size_t n) -> bool {
+        if (remaining < n) return false;
+        std::memcpy(dst, p, n);
+        p += n;
+        remaining -= n;
+        return true;
+    };
+
+    char magic[8];
+    uint32_t idCount = 0;
+    uint32_t courseCount = 0;
+    uint64_t poolSize = 0;
+    if (!readBytes(magic, sizeof magic) || std::memcmp(magic, kSnapshotMagic, sizeof magic) != 0) {
+        std::cerr << "ERROR: Not a course snapshot file: " << fileName << "\n";
+        return catalog;
+    }
+    if (!readBytes(&idCount, sizeof idCount) || !readBytes(&courseCount, sizeof courseCount)
+        || !readBytes(&poolSize, sizeof poolSize) || remaining < poolSize
+        || courseCount > idCount) {
+        std::cerr << "ERROR: Truncated snapshot file: " << fileName << "\n";
+        return catalog;
+    }
+
+    const char* pool = p;
+    p += poolSize;
+    remaining -= static_cast<size_t>(poolSize);
+
+    // Copies one pool slice into the catalog's arena and returns the view.
+    auto poolString = [&](uint32_t off, uint32_t len) -> std::string_view {
+        if (static_cast<uint64_t>(off) + len > poolSize) return std::string_view();
+        return catalog.arena->store(std::string_view(pool + off, len));
+    };
+
+    catalog.numberPool.reserve(idCount);
+    catalog.numberIds.reserve(idCount, catalog.numberPool);
+    catalog.courseIndexOfId.assign(idCount, kNoCourseIndex);
+    for (uint32_t id = 0; id < idCount; id++) {
+        uint32_t off, len;
+        if (!readBytes(&off, 4) || !readBytes(&len, 4)) {
+            std::cerr << "ERROR: Truncated snapshot file: " << fileName << "\n";
+            return Catalog();
+        }
+        catalog.numberPool.push_back(poolString(off, len));
+        catalog.numberIds.insert(id, catalog.numberPool.back(), catalog.numberPool);
+    }
+
+    catalog.courses.reserve(courseCount);
+    for (uint32_t i = 0; i < courseCount; i++) {
+        uint32_t numberId, titleOff, titleLen, prereqCount;
+        if (!readBytes(&numberId, 4) || !readBytes(&titleOff, 4) || !readBytes(&titleLen, 4)
+            || !readBytes(&prereqCount, 4) || remaining < static_cast<size_t>(prereqCount) * 4
+            || numberId >= idCount) {
+            std::cerr << "ERROR: Truncated snapshot file: " << fileName << "\n";
+            return Catalog();
+        }
+        Course c;
+        c.number = numberId;
+        c.title = poolString(titleOff, titleLen);
+        c.prerequisites.resize(prereqCount);
+        for (uint32_t j = 0; j < prereqCount; j++) {
+            readBytes(&c.prerequisites[j], 4);
+            if (c.prerequisites[j] >= idCount) {
+                std::cerr << "ERROR: Corrupt snapshot file: " << fileName << "\n";
+                return Catalog();
+            }
+        }
+        catalog.courseIndexOfId[numberId] = static_cast<uint32_t>(catalog.courses.size());
+        catalog.courses.push_back(std::move(c));
+    }
+
+    catalog.finalizeIndexes();
+    return catalog;
+}
+
+// Query formatters append into an application-side buffer so callers control
+// when bytes hit the stream: the REPL writes per invocation, batch mode writes
+// a whole command's output with one flush.
+
+static void appendCourseList(const Catalog& catalog, std::string& out) {
+    ScopedLatency timed(localPerfStats().listLatency);
+    if (catalog.empty()) {
+        out += "No course data loaded.\n";
+        return;
+    }
+
+    // Pure sequential scan over the two dense listing columns; no per-course
+    // indirection into the record array.
+    for (size_t i = 0; i < catalog.listNumbers.size(); i++) {
+        out.append(catalog.listNumbers[i]);
+        out += ", ";
+        out.append(catalog.listTitles[i]);
+        out += '\n';
+    }
+}
+
+static void appendCourseInfo(const Catalog& catalog, const std::string& inputCourseNumber,
+    std::string& out) {
+    ScopedLatency timed(localPerfStats().lookupLatency);
+    if (catalog.empty()) {
+        out += "No course data loaded.\n";
+        return;
+    }
+
+    std::string courseNumber = normalizeCourseNumber(inputCourseNumber);
+    const Course* course = catalog.findCourse(courseNumber);
+    if (course == nullptr) {
+        out += "Course not found: ";
+        out += courseNumber;
+        out += '\n';
+        return;
+    }
+
+    out.append(catalog.numberText(course->number));
+    out += ", ";
+    out.append(course->title);
+    out += '\n';
+
+    if (course->prerequisites.empty()) {
+        out += "Prerequisites: None\n";
+        return;
+    }
+
+    out += "Prerequisites:\n";
+    for (CourseId prereqId : course->prerequisites) {
+        const Course* prereq = catalog.courseForId(prereqId);
+        if (prereq != nullptr) {
+            out += "  ";
+            out.append(catalog.numberText(prereq->number));
+            out += ", ";
+            out.append(prereq->title);
+            out += '\n';
+        }
+        else {
+            // A prereq whose own row was skipped: we know the number, not the title
+            out += "  ";
+            out.append(catalog.numberText(prereqId));
+            out += " (missing info)\n";
+        }
+    }
+}
+
+// Full prerequisite closure for one course, listed in course-number order.
+static void appendCourseClosure(const Catalog& catalog, const std::string& inputCourseNumber,
+    std::string& out) {
+    if (catalog.empty()) {
+        out += "No course data loaded.\n";
+        return;
+    }
+
+    std::string courseNumber = normalizeCourseNumber(inputCourseNumber);
+    const Course* course = catalog.findCourse(courseNumber);
+    if (course == nullptr) {
+        out += "Course not found: ";
+        out += courseNumber;
+        out += '\n';
+        return;
+    }
+
+    out.append(catalog.numberText(course->number));
+    out += ", ";
+    out.append(course->title);
+    out += '\n';
+
+    uint32_t courseIndex = catalog.courseIndexOfId[course->number];
+    const std::vector<CourseId>& closure = catalog.prereqClosure(courseIndex);
+    if (closure.empty()) {
+        out += "All prerequisites: None\n";
+        return;
+    }
+
+    std::vector<CourseId> ordered(closure);
+    std::sort(ordered.begin(), ordered.end(), [&catalog](CourseId a, CourseId b) {
+        return catalog.numberText(a) < catalog.numberText(b);
+    });
+
+    out += "All prerequisites (";
+    out += std::to_string(ordered.size());
+    out += "):\n";
+    for (CourseId prereqId : ordered) {
+        const Course* prereq = catalog.courseForId(prereqId);
+        if (prereq != nullptr) {
+            out += "  ";
+            out.append(catalog.numberText(prereq->number));
+            out += ", ";
+            out.append(prereq->title);
+            out += '\n';
+        }
+        else {
+            out += "  ";
+            out.append(catalog.numberText(prereqId));
+            out += " (missing info)\n";
+        }
+    }
+}
+
+// Prefix query for autocomplete-style lookups ("CS2", "MATH1"). Binary-search
+// the maintained sorted index to the first candidate, then range-scan while
+// the prefix holds; the rest of the table is never touched.
+static void appendPrefixMatches(const Catalog& catalog, const std::string& inputPrefix,
+    std::string& out) {
+    if (catalog.empty()) {
+        out += "No course data loaded.\n";
+        return;
+    }
+
+    std::string prefix = normalizeCourseNumber(inputPrefix);
+    if (prefix.empty()) {
+        out += "No prefix given.\n";
+        return;
+    }
+
+    auto first = std::lower_bound(catalog.sortedCourses.begin(), catalog.sortedCourses.end(),
+        prefix, [&catalog](uint32_t idx, const std::string& p) {
+            return catalog.numberText(catalog.courses[idx].number) < p;
+        });
+
+    size_t matches = 0;
+    for (auto it = first; it != catalog.sortedCourses.end(); ++it) {
+        std::string_view number = catalog.numberText(catalog.courses[*it].number);
+        if (number.substr(0, prefix.size()) != prefix) {
+            break;
+        }
+        out.append(number);
+        out += ", ";
+        out.append(catalog.courses[*it].title);
+        out += '\n';
+        matches++;
+    }
+
+    if (matches == 0) {
+        out += "No courses match prefix: ";
+        out += prefix;
+        out += '\n';
+    }
+}
+
+// Reverse-dependency query: every course that lists the given one as a direct
+// prerequisite, in course-number order.
+// Range-scoped, paginated listing over the sorted index, so a front end can
+// render a 50-row page without shipping the whole catalog. The argument
+// grammar is `[<start>..<end>] [limit <n>] [after <courseNumber>]`: the range
+// is inclusive and either side may be omitted ("CS100..", "..CS499"), `limit`
+// caps the rows emitted, and `after` resumes strictly past a continuation
+// token. When a limit truncates the page, the last line is
+// `Next: <courseNumber>` -- feed it back via `after` for the next page. Each
+// page costs a binary search plus O(page) output.
+static void appendCourseListRange(const Catalog& catalog, const std::string& argument,
+    std::string& out) {
+    if (catalog.empty()) {
+        out += "No course data loaded.\n";
+        return;
+    }
+
+    std::string startKey, endKey, afterKey;
+    size_t limit = 0;
+    {
+        std::istringstream args(argument);
+        std::string token;
+        while (args >> token) {
+            if (token == "limit") {
+                if (!(args >> token)) {
+                    out += "ERROR: limit requires a count\n";
+                    return;
+                }
+                long n = std::atol(token.c_str());
+                if (n <= 0) {
+                    out += "ERROR: limit must be a positive number\n";
+                    return;
+                }
+                limit = static_cast<size_t>(n);
+            }
+            else if (token == "after") {
+                if (!(args >> token)) {
+                    out += "ERROR: after requires a course number\n";
+                    return;
+                }
+                afterKey = normalizeCourseNumber(token);
+            }
+            else if (token.find("..") != std::string::npos) {
+                size_t dots = token.find("..");
+                startKey = normalizeCourseNumber(token.substr(0, dots));
+                endKey = normalizeCourseNumber(token.substr(dots + 2));
+            }
+            else {
+                out += "ERROR: Unrecognized list argument: ";
+                out += token;
+                out += '\n';
+                return;
+            }
+        }
+    }
+
+    const std::vector<std::string_view>& numbers = catalog.listNumbers;
+    size_t begin = 0;
+    if (!startKey.empty()) {
+        begin = std::lower_bound(numbers.begin(), numbers.end(),
+            std::string_view(startKey)) - numbers.begin();
+    }
+    if (!afterKey.empty()) {
+        size_t resume = std::upper_bound(numbers.begin(), numbers.end(),
+            std::string_view(afterKey)) - numbers.begin();
+        if (resume > begin) begin = resume;
+    }
+    size_t end = numbers.size();
+    if (!endKey.empty()) {
+        end = std::upper_bound(numbers.begin(), numbers.end(),
+            std::string_view(endKey)) - numbers.begin();
+    }
+
+    if (begin >= end) {
+        out += "No courses in range.\n";
+        return;
+    }
+
+    size_t emitted = 0;
+    size_t i = begin;
+    for (; i < end; i++) {
+        if (limit > 0 && emitted == limit) break;
+        out.append(numbers[i]);
+        out += ", ";
+        out.append(catalog.listTitles[i]);
+        out += '\n';
+        emitted++;
+    }
+    if (i < end) {
+        out += "Next: ";
+        out.append(numbers[i - 1]);
+        out += '\n';
+    }
+}
+
+// Keyword search over titles. Query words are matched whole (not as
+// substrings) against the inverted index; courses matching more of the query
+// rank first, ties in course-number order. Cost is proportional to the
+// matching postings, never to catalog size.
+static void appendTitleSearch(const Catalog& catalog, const std::string& inputQuery,
+    std::string& out) {
+    if (catalog.empty()) {
+        out += "No course data loaded.\n";
+        return;
+    }
+
+    // Tokenize the query the same way the index tokenized titles.
+    std::vector<std::string> words;
+    {
+        std::string word;
+        for (size_t pos = 0; pos <= inputQuery.size(); pos++) {
+            char c = pos < inputQuery.size() ? inputQuery[pos] : ' ';
+            if (std::isalnum(static_cast<unsigned char>(c))) {
+                word += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                continue;
+            }
+            if (!word.empty()) {
+                words.push_back(word);
+                word.clear();
+            }
+        }
+    }
+    if (words.empty()) {
+        out += "No search words given.\n";
+        return;
+    }
+
+    // Count how many query words each candidate title matched.
+    std::unordered_map<uint32_t, uint32_t> hits;
+    for (const std::string& w : words) {
+        auto it = catalog.titleWords.find(w);
+        if (it == catalog.titleWords.end()) continue;
+        for (uint32_t courseIndex : it->second) {
+            hits[courseIndex]++;
+        }
+    }
+    if (hits.empty()) {
+        out += "No courses match the search.\n";
+        return;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> ranked; // (course index, match count)
+    ranked.reserve(hits.size());
+    for (const auto& entry : hits) ranked.emplace_back(entry.first, entry.second);
+    std::sort(ranked.begin(), ranked.end(),
+        [&catalog](const std::pair<uint32_t, uint32_t>& a,
+            const std::pair<uint32_t, uint32_t>& b) {
+            if (a.second != b.second) return a.second > b.second; // more words first
+            return catalog.numberText(catalog.courses[a.first].number)
+                < catalog.numberText(catalog.courses[b.first].number);
+        });
+
+    for (const auto& entry : ranked) {
+        const Course& course = catalog.courses[entry.first];
+        out.append(catalog.numberText(course.number));
+        out += ", ";
+        out.append(course.title);
+        out += '\n';
+    }
+}
+
+static void appendDependents(const Catalog& catalog, const std::string& inputCourseNumber,
+    std::string& out) {
+    if (catalog.empty()) {
+        out += "No course data loaded.\n";
+        return;
+    }
+
+    std::string courseNumber = normalizeCourseNumber(inputCourseNumber);
+    CourseId id = catalog.numberIds.find(courseNumber, catalog.numberPool);
+    if (id == kNoCourseIndex) {
+        out += "Course not found: ";
+        out += courseNumber;
+        out += '\n';
+        return;
+    }
+
+    const std::vector<uint32_t>& dependents = catalog.dependentsOfId[id];
+    if (dependents.empty()) {
+        out += "No courses require ";
+        out += courseNumber;
+        out += '\n';
+        return;
+    }
+
+    std::vector<uint32_t> ordered(dependents);
+    std::sort(ordered.begin(), ordered.end(), [&catalog](uint32_t a, uint32_t b) {
+        return catalog.numberText(catalog.courses[a].number)
+            < catalog.numberText(catalog.courses[b].number);
+    });
+
+    out += "Required by (";
+    out += std::to_string(ordered.size());
+    out += "):\n";
+    for (uint32_t idx : ordered) {
+        const Course& c = catalog.courses[idx];
+        out += "  ";
+        out.append(catalog.numberText(c.number));
+        out += ", ";
+        out.append(c.title);
+        out += '\n';
+    }
+}
+
+// Splits a space/comma/tab-separated list of course numbers, normalizing each.
+// Per-course graph metrics: longest prerequisite chain (precomputed at load,
+// incrementally maintained across deltas), transitive prerequisite count
+// (from the memoized closure), and direct dependent count (from the reverse
+// index). What used to be an external script re-reading the CSV is three
+// array reads here.
+static void appendCourseMetrics(const Catalog& catalog, const std::string& inputCourseNumber,
+    std::string& out) {
+    if (catalog.empty()) {
+        out += "No course data loaded.\n";
+        return;
+    }
+
+    std::string courseNumber = normalizeCourseNumber(inputCourseNumber);
+    const Course* course = catalog.findCourse(courseNumber);
+    if (course == nullptr) {
+        out += "Course not found: ";
+        out += courseNumber;
+        out += '\n';
+        return;
+    }
+    uint32_t courseIndex = static_cast<uint32_t>(course - catalog.courses.data());
+
+    out.append(catalog.numberText(course->number));
+    out += ", ";
+    out.append(course->title);
+    out += '\n';
+    out += "Chain depth: ";
+    out += std::to_string(catalog.chainDepth[courseIndex]);
+    out += '\n';
+    out += "Transitive prerequisites: ";
+    out += std::to_string(catalog.prereqClosure(courseIndex).size());
+    out += '\n';
+    out += "Direct dependents: ";
+    out += std::to_string(catalog.dependentsOfId[course->number].size());
+    out += '\n';
+}
+
+static std::vector<std::string> parseCourseList(const std::string& input) {
+    std::vector<std::string> numbers;
+    std::string current;
+    for (char ch : input + " ") {
+        if (ch == ' ' || ch == ',' || ch == '\t') {
+            if (!current.empty()) {
+                numbers.push_back(normalizeCourseNumber(current));
+                current.clear();
+            }
+        }
+        else {
+            current += ch;
+        }
+    }
+    return numbers;
+}
+
+// Semester-by-semester plan for one or more target courses: gathers each
+// target's transitive closure, then runs Kahn's algorithm over that subgraph,
+// emitting one layer per semester (everything in a layer has all prereqs in
+// earlier layers). Courses left over after the peel are stuck in a
+// prerequisite cycle and are reported like the loader's per-line errors.
+static void appendCoursePlan(const Catalog& catalog, const std::string& inputTargets,
+    std::string& out) {
+    if (catalog.empty()) {
+        out += "No course data loaded.\n";
+        return;
+    }
+
+    // Targets may be separated by spaces or commas.
+    std::vector<std::string> targets = parseCourseList(inputTargets);
+    if (targets.empty()) {
+        out += "No target course given.\n";
+        return;
+    }
+
+    // Needed subgraph: every target plus its full closure (records only; a
+    // prereq id without a record cannot be scheduled and is called out).
+    std::vector<uint32_t> needed;
+    std::vector<uint8_t> inPlan(catalog.courses.size(), 0);
+    std::vector<CourseId> unavailable;
+    for (const std::string& target : targets) {
+        const Course* course = catalog.findCourse(target);
+        if (course == nullptr) {
+            out += "Course not found: ";
+            out += target;
+            out += '\n';
+            return;
+        }
+        uint32_t courseIndex = catalog.courseIndexOfId[course->number];
+        auto require = [&](uint32_t idx) {
+            if (!inPlan[idx]) {
+                inPlan[idx] = 1;
+                needed.push_back(idx);
+            }
+        };
+        require(courseIndex);
+        for (CourseId pid : catalog.prereqClosure(courseIndex)) {
+            uint32_t pidx = catalog.courseIndexOfId[pid];
+            if (pidx != kNoCourseIndex) {
+                require(pidx);
+            }
+            else {
+                unavailable.push_back(pid);
+            }
+        }
+    }
+
+    // Kahn's algorithm, peeling zero-indegree layers. Only edges inside the
+    // subgraph count; prereqs without records cannot gate anything.
+    std::vector<uint32_t> indegree(catalog.courses.size(), 0);
+    for (uint32_t idx : needed) {
+        for (CourseId pid : catalog.courses[idx].prerequisites) {
+            uint32_t pidx = catalog.courseIndexOfId[pid];
+            if (pidx != kNoCourseIndex && inPlan[pidx]) {
+                indegree[idx]++;
+            }
+        }
+    }
+
+    out += "Plan (";
+    out += std::to_string(needed.size());
+    out += " courses):\n";
+
+    std::vector<uint32_t> ready;
+    for (uint32_t idx : needed) {
+        if (indegree[idx] == 0) ready.push_back(idx);
+    }
+    size_t placed = 0;
+    unsigned semester = 0;
+    while (!ready.empty()) {
+        semester++;
+        std::sort(ready.begin(), ready.end(), [&catalog](uint32_t a, uint32_t b) {
+            return catalog.numberText(catalog.courses[a].number)
+                < catalog.numberText(catalog.courses[b].number);
+        });
+        out += "Semester ";
+        out += std::to_string(semester);
+        out += ":\n";
+        std::vector<uint32_t> next;
+        for (uint32_t idx : ready) {
+            const Course& c = catalog.courses[idx];
+            out += "  ";
+            out.append(catalog.numberText(c.number));
+            out += ", ";
+            out.append(c.title);
+            out += '\n';
+            placed++;
+            for (uint32_t didx : catalog.dependentsOfId[c.number]) {
+                if (inPlan[didx] && --indegree[didx] == 0) {
+                    next.push_back(didx);
+                }
+            }
+        }
+        ready = std::move(next);
+    }
+
+    // Anything not placed is trapped in a prerequisite cycle.
+    if (placed < needed.size()) {
+        for (uint32_t idx : needed) {
+            if (indegree[idx] > 0) {
+                std::cerr << "ERROR: Prerequisite cycle involving '"
+                    << catalog.numberText(catalog.courses[idx].number)
+                    << "' (cannot schedule)\n";
+            }
+        }
+    }
+
+    if (!unavailable.empty()) {
+        std::sort(unavailable.begin(), unavailable.end());
+        unavailable.erase(std::unique(unavailable.begin(), unavailable.end()),
+            unavailable.end());
+        out += "Not in catalog (listed as prerequisites only):\n";
+        for (CourseId pid : unavailable) {
+            out += "  ";
+            out.append(catalog.numberText(pid));
+            out += '\n';
+        }
+    }
+}
+
+// Batched lookup: resolves a whole list of course numbers in one pass and
+// emits one buffered response, amortizing REPL and flush overhead across a
+// degree audit's 40-60 lookups. Probes run in sorted order for locality; the
+// output preserves the caller's order.
+static void appendCourseInfoBatch(const Catalog& catalog, const std::string& inputCourseNumbers,
+    std::string& out) {
+    if (catalog.empty()) {
+        out += "No course data loaded.\n";
+        return;
+    }
+
+    std::vector<std::string> numbers = parseCourseList(inputCourseNumbers);
+    if (numbers.empty()) {
+        out += "No course numbers given.\n";
+        return;
+    }
+
+    // Resolve in sorted probe order, then emit in input order.
+    std::vector<uint32_t> probeOrder(numbers.size());
+    for (uint32_t i = 0; i < probeOrder.size(); i++) probeOrder[i] = i;
+    std::sort(probeOrder.begin(), probeOrder.end(), [&numbers](uint32_t a, uint32_t b) {
+        return numbers[a] < numbers[b];
+    });
+    std::vector<const Course*> resolved(numbers.size());
+    for (uint32_t i : probeOrder) {
+        resolved[i] = catalog.findCourse(numbers[i]);
+    }
+
+    for (size_t i = 0; i < numbers.size(); i++) {
+        const Course* course = resolved[i];
+        if (course == nullptr) {
+            out += "Course not found: ";
+            out += numbers[i];
+            out += '\n';
+            continue;
+        }
+        out.append(catalog.numberText(course->number));
+        out += ", ";
+        out.append(course->title);
+        if (!course->prerequisites.empty()) {
+            out += " | Prerequisites:";
+            for (CourseId prereqId : course->prerequisites) {
+                out += ' ';
+                out.append(catalog.numberText(prereqId));
+            }
+        }
+        out += '\n';
+    }
+}
+
+// ---------- Runtime statistics ----------
+
+static void appendLatencyLine(const char* name, const LatencyTotals& h,
+    std::string& out) {
+    out += name;
+    if (h.count == 0) {
+        out += ": no samples\n";
+        return;
+    }
+    out += ": count ";
+    out += std::to_string(h.count);
+    out += ", avg ";
+    out += std::to_string(h.totalNs / h.count);
+    out += " ns, max ";
+    out += std::to_string(h.maxNs);
+    out += " ns\n";
+    for (unsigned b = 0; b < 40; b++) {
+        if (h.buckets[b] == 0) continue;
+        out += "      < ";
+        out += std::to_string(uint64_t(1) << (b + 1));
+        out += " ns: ";
+        out += std::to_string(h.buckets[b]);
+        out += '\n';
+    }
+}
+
+static void appendStats(std::string& out) {
+    PerfTotals totals = gatherPerfStats();
+    out += "Runtime statistics:\n";
+    appendLatencyLine("  load", totals.loadLatency, out);
+    appendLatencyLine("  list", totals.listLatency, out);
+    appendLatencyLine("  lookup", totals.lookupLatency, out);
+    out += "  index probes: ";
+    out += std::to_string(totals.probeCount);
+    if (totals.probeCount > 0) {
+        // Average chain length to two decimals without pulling in float I/O.
+        uint64_t hundredths = totals.probeSteps * 100 / totals.probeCount;
+        out += ", avg chain ";
+        out += std::to_string(hundredths / 100);
+        out += '.';
+        out += static_cast<char>('0' + (hundredths / 10) % 10);
+        out += static_cast<char>('0' + hundredths % 10);
+        out += ", max chain ";
+        out += std::to_string(totals.probeMax);
+    }
+    out += '\n';
+    out += "  arena: ";
+    out += std::to_string(totals.arenaChunks);
+    out += " chunk allocations, ";
+    out += std::to_string(totals.arenaBytes);
+    out += " bytes interned\n";
+    out += "  bloom: ";
+    out += std::to_string(totals.bloomRejects);
+    out += " misses rejected before probing\n";
+}
+
+// Machine-readable dump for scrapers: one key=value per line, written on exit
+// to the file named by $ABCU_STATS_FILE when that variable is set.
+static void dumpStatsFile() {
+    const char* path = std::getenv("ABCU_STATS_FILE");
+    if (path == nullptr || *path == '\0') return;
+
+    std::ofstream outFile(path, std::ios::trunc);
+    if (!outFile.is_open()) {
+        std::cerr << "ERROR: Could not write stats file: " << path << "\n";
+        return;
+    }
+    PerfTotals totals = gatherPerfStats();
+    const struct { const char* name; const LatencyTotals* h; } histos[] = {
+        { "load", &totals.loadLatency },
+        { "list", &totals.listLatency },
+        { "lookup", &totals.lookupLatency },
+    };
+    for (const auto& entry : histos) {
+        outFile << entry.name << ".count=" << entry.h->count << "\n";
+        outFile << entry.name << ".total_ns=" << entry.h->totalNs << "\n";
+        outFile << entry.name << ".max_ns=" << entry.h->maxNs << "\n";
+    }
+    outFile << "probe.count=" << totals.probeCount << "\n";
+    outFile << "probe.steps=" << totals.probeSteps << "\n";
+    outFile << "probe.max=" << totals.probeMax << "\n";
+    outFile << "arena.chunks=" << totals.arenaChunks << "\n";
+    outFile << "arena.bytes=" << totals.arenaBytes << "\n";
+    outFile << "bloom.rejects=" << totals.bloomRejects << "\n";
+}
+
+static void printCourseListSorted(const Catalog& catalog) {
+    std::string out;
+    appendCourseList(catalog, out);
+    std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+}
+
+static void printCourseInfo(const Catalog& catalog, const std::string& inputCourseNumber) {
+    std::string out;
+    appendCourseInfo(catalog, inputCourseNumber, out);
+    std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+}
+
+static void printMenu() {
+    std::cout << "\nMenu:\n";
+    std::cout << "  1. Load Data Structure\n";
+    std::cout << "  2. Print Course List\n";
+    std::cout << "  3. Print Course\n";
+    std::cout << "  4. Save Snapshot\n";
+    std::cout << "  5. Load Snapshot\n";
+    std::cout << "  6. Print Full Prerequisites\n";
+    std::cout << "  7. Search by Course Prefix\n";
+    std::cout << "  8. Apply Delta File\n";
+    std::cout << "  10. Print Dependent Courses\n";
+    std::cout << "  11. Plan Course Sequence\n";
+    std::cout << "  12. Print Multiple Courses\n";
+    std::cout << "  13. Print Runtime Stats\n";
+    std::cout << "  14. Search by Title Keyword\n";
+    std::cout << "  15. Switch Catalog (multi-term)\n";
+    std::cout << "  16. Print Course Metrics\n";
+    std::cout << "  9. Exit\n";
+    std::cout << "Enter your choice: ";
+}
+
+static bool readIntChoice(int& outChoice) {
+    std::string line;
+    if (!std::getline(std::cin, line)) return false;
+    line = trim(line);
+    if (line.empty()) return false;
+
+    // Basic numeric parse
+    try {
+        size_t idx = 0;
+        int val = std::stoi(line, &idx);
+        if (idx != line.size()) return false;
+        outChoice = val;
+        return true;
+    }
+    catch (...) {
+        return false;
+    }
+}
+
+// ---------- Streaming low-memory mode ----------
+//
+// For archives that do not fit in RAM: one pass over the mapped file builds a
+// compact sorted index of {course number, row offset}, and queries seek back
+// into the mapping and parse only the rows they need. Resident memory is
+// O(index) — the numbers and offsets — not O(catalog); titles and
+// prerequisite lists live in the file until a query touches them, with a
+// small LRU cache absorbing repeat hits on hot courses. Prerequisite
+// references are resolved against the index (a number missing from it prints
+// as "(missing info)", like the in-memory path).
+class StreamingCatalog {
+public:
+    explicit StreamingCatalog(const std::string& fileName) : file(fileName) {
+        if (!file.ok) {
+            std::cerr << "ERROR: Could not open file: " << fileName << "\n";
+            return;
+        }
+        buildIndex();
+        opened = true;
+    }
+
+    bool ok() const { return opened; }
+    size_t size() const { return index.size(); }
+
+    // Streams every row in sorted order, writing the buffer out whenever it
+    // fills, so resident memory stays bounded by the chunk size no matter how
+    // large the catalog is -- the multi-year archive must not be materialized
+    // as one giant listing string.
+    void streamList(std::ostream& out) {
+        std::string buffer;
+        buffer.reserve(kListChunkBytes + 256);
+        std::vector<std::string_view> tokens;
+        for (const IndexEntry& entry : index) {
+            splitRow(entry, tokens);
+            buffer += entry.number;
+            buffer += ", ";
+            buffer.append(tokens.size() >= 2 ? tokens[1] : std::string_view());
+            buffer += '\n';
+            if (buffer.size() >= kListChunkBytes) {
+                out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                buffer.clear();
+            }
+        }
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    }
+
+    void appendInfo(const std::string& inputCourseNumber, std::string& out) {
+        std::string courseNumber = normalizeCourseNumber(inputCourseNumber);
+        const IndexEntry* entry = lookup(courseNumber);
+        if (entry == nullptr) {
+            out += "Course not found: ";
+            out += courseNumber;
+            out += '\n';
+            return;
+        }
+
+        // Copy, not reference: each prereq fetch below can evict this row
+        // from the LRU, and a course with more prerequisites than the cache
+        // holds would otherwise leave the loop walking a destroyed entry.
+        CachedRow row = fetch(*entry);
+        out += entry->number;
+        out += ", ";
+        out += row.title;
+        out += '\n';
+
+        if (row.prerequisites.empty()) {
+            out += "Prerequisites: None\n";
+            return;
+        }
+        out += "Prerequisites:\n";
+        for (const std::string& prereq : row.prerequisites) {
+            const IndexEntry* prereqEntry = lookup(prereq);
+            if (prereqEntry != nullptr) {
+                const CachedRow& prereqRow = fetch(*prereqEntry);
+                out += "  ";
+                out += prereq;
+                out += ", ";
+                out += prereqRow.title;
+                out += '\n';
+            }
+            else {
+                out += "  ";
+                out += prereq;
+                out += " (missing info)\n";
+            }
+        }
+    }
+
+private:
+    struct IndexEntry {
+        std::string number;
+        uint64_t offset = 0; // byte offset of the row; files past 4GiB are in scope here
+        uint32_t length = 0;
+        uint32_t lineNumber = 0;
+    };
+
+    struct CachedRow {
+        std::string title;
+        std::vector<std::string> prerequisites;
+    };
+
+    static constexpr size_t kCacheCapacity = 256;
+    static constexpr size_t kListChunkBytes = 1 << 20; // listing flush granularity
+
+    // One format-checking pass over the file; only numbers and offsets are
+    // kept. Bad rows and duplicates get the loader's usual per-line errors.
+    void buildIndex() {
+        std::string_view contents = file.view();
+        std::vector<std::string_view> tokens;
+        uint32_t lineNumber = 0;
+        size_t pos = 0;
+        while (pos < contents.size()) {
+            size_t nl = findByte(contents, '\n', pos);
+            size_t end = (nl == std::string_view::npos) ? contents.size() : nl;
+            std::string_view line = contents.substr(pos, end - pos);
+            size_t lineStart = pos;
+            pos = (nl == std::string_view::npos) ? contents.size() : nl + 1;
+            lineNumber++;
+
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            if (trimView(line).empty()) {
+                continue;
+            }
+            splitByComma(line, tokens);
+            if (tokens.size() < 2) {
+                std::cerr << "ERROR: Bad format on line " << lineNumber << " (skipping line)\n";
+                continue;
+            }
+            std::string courseNum = normalizeCourseNumber(tokens[0]);
+            if (courseNum.empty() || tokens[1].empty()) {
+                std::cerr << "ERROR: Missing courseNumber/title on line " << lineNumber
+                    << " (skipping line)\n";
+                continue;
+            }
+
+            IndexEntry entry;
+            entry.number = std::move(courseNum);
+            entry.offset = lineStart;
+            entry.length = static_cast<uint32_t>(line.size());
+            entry.lineNumber = lineNumber;
+            index.push_back(std::move(entry));
+        }
+
+        // Sort by number; first file occurrence wins on duplicates, matching
+        // the in-memory loader.
+        std::stable_sort(index.begin(), index.end(),
+            [](const IndexEntry& a, const IndexEntry& b) {
+                if (a.number != b.number) return a.number < b.number;
+                return a.lineNumber < b.lineNumber;
+            });
+        std::vector<IndexEntry> unique;
+        unique.reserve(index.size());
+        for (auto& entry : index) {
+            if (!unique.empty() && unique.back().number == entry.number) {
+                std::cerr << "ERROR: Duplicate courseNumber '" << entry.number << "' on line "
+                    << entry.lineNumber << " (skipping line)\n";
+                continue;
+            }
+            unique.push_back(std::move(entry));
+        }
+        index = std::move(unique);
+    }
+
+    const IndexEntry* lookup(const std::string& courseNumber) const {
+        auto it = std::lower_bound(index.begin(), index.end(), courseNumber,
+            [](const IndexEntry& entry, const std::string& key) {
+                return entry.number < key;
+            });
+        if (it == index.end() || it->number != courseNumber) return nullptr;
+        return &*it;
+    }
+
+    void splitRow(const IndexEntry& entry, std::vector<std::string_view>& tokens) const {
+        std::string_view line = file.view().substr(entry.offset, entry.length);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        splitByComma(line, tokens);
+    }
+
+    // Parses the row behind an index entry, through the LRU cache.
+    const CachedRow& fetch(const IndexEntry& entry) {
+        auto hit = cacheMap.find(entry.number);
+        if (hit != cacheMap.end()) {
+            cacheList.splice(cacheList.begin(), cacheList, hit->second);
+            return hit->second->second;
+        }
+
+        std::vector<std::string_view> tokens;
+        splitRow(entry, tokens);
+        CachedRow row;
+        row.title = std::string(tokens.size() >= 2 ? tokens[1] : std::string_view());
+        for (size_t i = 2; i < tokens.size(); i++) {
+            std::string prereq = normalizeCourseNumber(tokens[i]);
+            if (!prereq.empty()) {
+                row.prerequisites.push_back(std::move(prereq));
+            }
+        }
+
+        cacheList.emplace_front(entry.number, std::move(row));
+        cacheMap[entry.number] = cacheList.begin();
+        if (cacheList.size() > kCacheCapacity) {
+            cacheMap.erase(cacheList.back().first);
+            cacheList.pop_back();
+        }
+        return cacheList.front().second;
+    }
+
+    MappedFile file;
+    bool opened = false;
+    std::vector<IndexEntry> index;
+    std::list<std::pair<std::string, CachedRow>> cacheList; // front = most recent
+    std::unordered_map<std::string, std::list<std::pair<std::string, CachedRow>>::iterator>
+        cacheMap;
+};
+
+// Low-memory REPL: the catalog stays on disk, only the index is resident.
+static int runStream(const std::string& fileName) {
+    StreamingCatalog streaming(fileName);
+    if (!streaming.ok()) {
+        return 1;
+    }
+    std::cout << "Streaming mode: " << streaming.size() << " courses indexed.\n";
+
+    int choice = 0;
+    while (true) {
+        std::cout << "\nMenu:\n";
+        std::cout << "  2. Print Course List\n";
+        std::cout << "  3. Print Course\n";
+        std::cout << "  9. Exit\n";
+        std::cout << "Enter your choice: ";
+        if (!readIntChoice(choice)) {
+            std::cout << "Invalid input. Please enter 2, 3, or 9.\n";
+            continue;
+        }
+        if (choice == 2) {
+            streaming.streamList(std::cout);
+        }
+        else if (choice == 3) {
+            std::string courseNumber;
+            std::cout << "Enter a course number (e.g., CS200): ";
+            std::getline(std::cin, courseNumber);
+            std::string out;
+            streaming.appendInfo(courseNumber, out);
+            std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+        }
+        else if (choice == 9) {
+            std::cout << "Goodbye.\n";
+            break;
+        }
+        else {
+            std::cout << "Invalid option. Please enter 2, 3, or 9.\n";
+        }
+    }
+    return 0;
+}
+
+// ---------- Benchmark harness ----------
+//
+// First-party timings for the load and query paths, isolated from REPL I/O:
+// `ProjectTwo --bench [courseCount] [prereqFanout]` generates a synthetic
+// catalog, runs each stage, and reports ns/op and rows/sec plus peak RSS.
+// Every loop feeds a checksum that gets printed, so nothing is dead code to
+// the optimizer.
+
+static double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+static int runBench(size_t courseCount, unsigned fanout) {
+    std::cerr << "Benchmark: " << courseCount << " courses, prereq fanout " << fanout << "\n";
+
+    // ----- Synthesize a catalog file -----
+    const std::string benchFile = "abcu-bench.csv";
+    std::mt19937 rng(12345);
+    {
+        std::string data;
+        data.reserve(courseCount * 40);
+        char number[24];
+        for (size_t i = 0; i < courseCount; i++) {
+            std::snprintf(number, sizeof number, "B%07zu", i);
+            data += number;
+            data += ",Synthetic Course Title ";
+            data += std::to_string(i);
+            if (i > 0 && fanout > 0) {
+                unsigned links = rng() % (fanout + 1);
+                for (unsigned j = 0; j < links; j++) {
+                    std::snprintf(number, sizeof number, ",B%07zu",
+                        static_cast<size_t>(rng() % i));
+                    data += number;
+                }
+            }
+            data += '\n';
+        }
+        std::ofstream out(benchFile, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    uint64_t checksum = 0;
+
+    // ----- Full load -----
+    auto t0 = std::chrono::steady_clock::now();
+    Catalog catalog = loadCoursesFromFile(benchFile);
+    double loadNs = elapsedNs(t0);
+    checksum += catalog.size();
+    std::cerr << "load:       " << loadNs / 1e6 << " ms, "
+        << static_cast<double>(catalog.size()) / (loadNs / 1e9) << " rows/sec\n";
+
+    // ----- splitByComma over a sample line -----
+    {
+        constexpr size_t kIters = 2000000;
+        std::string_view sample = "CSCI300,Introduction to Algorithms,CSCI200,MATH201";
+        std::vector<std::string_view> tokens;
+        t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kIters; i++) {
+            splitByComma(sample, tokens);
+            checksum += tokens.size();
+        }
+        std::cerr << "split:      " << elapsedNs(t0) / kIters << " ns/op\n";
+    }
+
+    // ----- normalizeCourseNumber -----
+    {
+        constexpr size_t kIters = 2000000;
+        t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kIters; i++) {
+            checksum += normalizeCourseNumber(std::string_view("  csci300  ")).size();
+        }
+        std::cerr << "normalize:  " << elapsedNs(t0) / kIters << " ns/op\n";
+    }
+
+    // ----- Table lookup: random existing course numbers -----
+    {
+        constexpr size_t kIters = 1000000;
+        std::vector<std::string> probes;
+        probes.reserve(1024);
+        for (size_t i = 0; i < 1024; i++) {
+            char number[24];
+            std::snprintf(number, sizeof number, "B%07zu",
+                static_cast<size_t>(rng() % courseCount));
+            probes.emplace_back(number);
+        }
+        t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kIters; i++) {
+            const Course* c = catalog.findCourse(probes[i & 1023]);
+            if (c != nullptr) checksum += c->number;
+        }
+        std::cerr << "lookup:     " << elapsedNs(t0) / kIters << " ns/op\n";
+    }
+
+    // ----- Sorted listing into the output buffer -----
+    {
+        std::string out;
+        out.reserve(courseCount * 40);
+        t0 = std::chrono::steady_clock::now();
+        appendCourseList(catalog, out);
+        double listNs = elapsedNs(t0);
+        checksum += out.size();
+        std::cerr << "list:       " << listNs / 1e6 << " ms, "
+            << static_cast<double>(catalog.size()) / (listNs / 1e9) << " rows/sec\n";
+    }
+
+#if ABCU_HAVE_MMAP
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        std::cerr << "peak RSS:   " << usage.ru_maxrss / 1024 << " MB\n";
+    }
+#endif
+
+    std::cerr << "checksum:   " << checksum << "\n";
+    std::remove(benchFile.c_str());
+    return 0;
+}
+
+// ---------- Startup configuration ----------
+//
+// Kiosk deployments need the program usable without a pty wrapper: a config
+// file (default abcu.cfg beside the binary, or --config <file>) can name the
+// catalog to preload before the menu appears. Keys, one per line, '#' for
+// comments:
+//   dataFile=<csv>         load this catalog at startup
+//   snapshotFile=<snap>    load this snapshot at startup (wins over dataFile)
+//   loadThreads=<n>        parallel-load worker count (env var still wins)
+//   warmCache=true         pre-fault the table and indexes after preload
+struct StartupConfig {
+    std::string dataFile;
+    std::string snapshotFile;
+    unsigned loadThreads = 0;
+    bool warmCache = false;
+};
+
+static bool parseConfigFile(const std::string& fileName, StartupConfig& config) {
+    std::ifstream in(fileName);
+    if (!in.is_open()) {
+        return false;
+    }
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        size_t eq = line.find('=');
+        if (eq == std::string::npos) {
+            std::cerr << "WARNING: Bad config line " << lineNumber << " in " << fileName
+                << " (ignoring)\n";
+            continue;
+        }
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+        if (key == "dataFile") {
+            config.dataFile = value;
+        }
+        else if (key == "snapshotFile") {
+            config.snapshotFile = value;
+        }
+        else if (key == "loadThreads") {
+            int n = std::atoi(value.c_str());
+            if (n > 0) config.loadThreads = static_cast<unsigned>(n);
+        }
+        else if (key == "warmCache") {
+            config.warmCache = (value == "true" || value == "1" || value == "yes");
+        }
+        else {
+            std::cerr << "WARNING: Unknown config key '" << key << "' in " << fileName
+                << " (ignoring)\n";
+        }
+    }
+    return true;
+}
+
+// Touches every page behind the table and indexes so the first advisor query
+// runs against warm caches instead of paying the fault cost itself.
+static void warmCatalog(const Catalog& catalog) {
+    size_t sink = 0;
+    for (uint32_t idx : catalog.sortedCourses) {
+        const Course& c = catalog.courses[idx];
+        sink += catalog.numberText(c.number).size() + c.title.size();
+        for (CourseId pid : c.prerequisites) {
+            sink += pid;
+        }
+    }
+    for (const auto& dependents : catalog.dependentsOfId) {
+        sink += dependents.size();
+    }
+    // Probe a sample of keys so the hash index pages fault in too.
+    for (size_t i = 0; i < catalog.numberPool.size(); i += 16) {
+        sink += catalog.numberIds.find(catalog.numberPool[i], catalog.numberPool);
+    }
+    volatile size_t keep = sink;
+    (void)keep;
+}
+
+// ---------- Batch mode ----------
+//
+// Non-interactive command protocol for pipelines: no prompts, commands run
+// back-to-back, and each command's output goes out as one buffered write with
+// a single flush. Lines are `load <file> [as <catalog>]`, `use <catalog>`,
+// `catalogs`,
+// `list [<start>..<end>] [limit <n>] [after <courseNumber>]`, `info <courseNumber>`,
+// `infos <courseNumber...>`,
+// `closure <courseNumber>`, `prefix <courseNumberPrefix>`,
+// `dependents <courseNumber>`, `plan <courseNumber...>`, `delta <file>`,
+// `save <file>`
+// (snapshot), `metrics <courseNumber>`, `search <keyword...>`, `stats`,
+// `quit`; blank lines
+// and lines starting with '#' are ignored.
+static int runBatch(std::istream& in) {
+    CatalogRegistry store;
+    std::string line;
+    std::string out;
+    out.reserve(1 << 20);
+
+    while (std::getline(in, line)) {
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::string command = line;
+        std::string argument;
+        size_t space = line.find(' ');
+        if (space != std::string::npos) {
+            command = line.substr(0, space);
+            argument = trim(line.substr(space + 1));
+        }
+
+        out.clear();
+        if (command == "load") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: load requires a file name\n";
+                continue;
+            }
+            // `load <file> [as <name>]` targets a named catalog; unchanged
+            // string bytes are shared with the previously loaded term.
+            std::string fileArg = argument;
+            std::string targetName = store.activeName();
+            size_t asPos = fileArg.rfind(" as ");
+            if (asPos != std::string::npos) {
+                targetName = trim(fileArg.substr(asPos + 4));
+                fileArg = trim(fileArg.substr(0, asPos));
+                if (targetName.empty() || fileArg.empty()) {
+                    std::cerr << "ERROR: load requires a file name and catalog name\n";
+                    continue;
+                }
+            }
+            std::shared_ptr<const Catalog> shareFrom = store.shareBaseFor(targetName);
+            if (targetName != store.activeName()) {
+                store.select(targetName);
+            }
+            store.publish(loadCoursesFromFile(fileArg, std::move(shareFrom)));
+            out += "Loaded ";
+            out += std::to_string(store.current()->size());
+            out += " courses into '";
+            out += targetName;
+            out += "'.\n";
+        }
+        else if (command == "use") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: use requires a catalog name\n";
+                continue;
+            }
+            store.select(argument);
+            out += "Active catalog: ";
+            out += argument;
+            out += " (";
+            out += std::to_string(store.current()->size());
+            out += " courses).\n";
+        }
+        else if (command == "catalogs") {
+            store.appendList(out);
+        }
+        else if (command == "list") {
+            if (argument.empty()) {
+                appendCourseList(*store.current(), out);
+            }
+            else {
+                appendCourseListRange(*store.current(), argument, out);
+            }
+        }
+        else if (command == "info") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: info requires a course number\n";
+                continue;
+            }
+            appendCourseInfo(*store.current(), argument, out);
+        }
+        else if (command == "closure") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: closure requires a course number\n";
+                continue;
+            }
+            appendCourseClosure(*store.current(), argument, out);
+        }
+        else if (command == "prefix") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: prefix requires a course-number prefix\n";
+                continue;
+            }
+            appendPrefixMatches(*store.current(), argument, out);
+        }
+        else if (command == "dependents") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: dependents requires a course number\n";
+                continue;
+            }
+            appendDependents(*store.current(), argument, out);
+        }
+        else if (command == "infos") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: infos requires one or more course numbers\n";
+                continue;
+            }
+            appendCourseInfoBatch(*store.current(), argument, out);
+        }
+        else if (command == "plan") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: plan requires one or more course numbers\n";
+                continue;
+            }
+            appendCoursePlan(*store.current(), argument, out);
+        }
+        else if (command == "delta") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: delta requires a file name\n";
+                continue;
+            }
+            Catalog next;
+            if (!applyDeltaFile(*store.current(), argument, next)) {
+                continue; // error already reported; keep the current generation
+            }
+            store.publish(std::move(next));
+            out += "Delta applied (";
+            out += std::to_string(store.current()->size());
+            out += " courses).\n";
+        }
+        else if (command == "save") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: save requires a file name\n";
+                continue;
+            }
+            if (saveSnapshot(*store.current(), argument)) {
+                out += "Snapshot saved.\n";
+            }
+        }
+        else if (command == "restore") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: restore requires a file name\n";
+                continue;
+            }
+            store.publish(loadSnapshot(argument));
+            out += "Restored ";
+            out += std::to_string(store.current()->size());
+            out += " courses.\n";
+        }
+        else if (command == "metrics") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: metrics requires a course number\n";
+                continue;
+            }
+            appendCourseMetrics(*store.current(), argument, out);
+        }
+        else if (command == "search") {
+            if (argument.empty()) {
+                std::cerr << "ERROR: search requires one or more keywords\n";
+                continue;
+            }
+            appendTitleSearch(*store.current(), argument, out);
+        }
+        else if (command == "stats") {
+            appendStats(out);
+        }
+        else if (command == "quit") {
+            break;
+        }
+        else {
+            std::cerr << "ERROR: Unknown command: " << command << "\n";
+            continue;
+        }
+
+        std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+        std::cout.flush(); // single flush per command
+    }
+    dumpStatsFile();
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // `ProjectTwo --batch [commands.txt]` suppresses the menu REPL and runs
+    // the command protocol from the given file (or stdin if omitted).
+    // `ProjectTwo --bench [courseCount] [prereqFanout]` runs the benchmark
+    // harness against a synthetic catalog and exits.
+    if (argc >= 2 && std::strcmp(argv[1], "--bench") == 0) {
+        size_t courseCount = 100000;
+        unsigned fanout = 3;
+        if (argc >= 3) {
+            long n = std::atol(argv[2]);
+            if (n > 0) courseCount = static_cast<size_t>(n);
+        }
+        if (argc >= 4) {
+            int f = std::atoi(argv[3]);
+            if (f >= 0) fanout = static_cast<unsigned>(f);
+        }
+        return runBench(courseCount, fanout);
+    }
+
+    // `ProjectTwo --stream <file>` serves queries from an on-disk index
+    // without materializing the catalog; for archives larger than RAM.
+    if (argc >= 3 && std::strcmp(argv[1], "--stream") == 0) {
+        return runStream(argv[2]);
+    }
+
+    if (argc >= 2 && std::strcmp(argv[1], "--batch") == 0) {
+        std::ios::sync_with_stdio(false);
+        if (argc >= 3) {
+            std::ifstream commands(argv[2]);
+            if (!commands.is_open()) {
+                std::cerr << "ERROR: Could not open command file: " << argv[2] << "\n";
+                return 1;
+            }
+            return runBatch(commands);
+        }
+        return runBatch(std::cin);
+    }
+
+    // Non-interactive startup: `ProjectTwo [--config <file>] [dataFile]`.
+    // The config file (default abcu.cfg when present) or a positional data
+    // file preloads the catalog before the menu, so supervised kiosks reach a
+    // usable state without a pty wrapper feeding the filename prompt.
+    StartupConfig config;
+    {
+        int argIndex = 1;
+        if (argc >= 3 && std::strcmp(argv[1], "--config") == 0) {
+            if (!parseConfigFile(argv[2], config)) {
+                std::cerr << "ERROR: Could not open config file: " << argv[2] << "\n";
+                return 1;
+            }
+            argIndex = 3;
+        }
+        else {
+            parseConfigFile("abcu.cfg", config); // optional; silent if absent
+        }
+        if (argIndex < argc) {
+            config.dataFile = argv[argIndex]; // positional file beats config
+        }
+    }
+    if (config.loadThreads > 0) {
+        configLoadThreads = config.loadThreads;
+    }
+
+    std::cout << "Welcome to ABCU Advising Program\n";
+
+    CatalogRegistry store;
+    bool dataLoaded = false;
+
+    std::string fileName = config.dataFile;
+    if (!config.snapshotFile.empty()) {
+        store.publish(loadSnapshot(config.snapshotFile));
+    }
+    else if (!fileName.empty()) {
+        store.publish(loadCoursesFromFile(fileName));
+    }
+    if (!store.current()->empty()) {
+        dataLoaded = true;
+        if (config.warmCache) {
+            warmCatalog(*store.current());
+        }
+        std::cout << "Data loaded successfully (" << store.current()->size()
+            << " courses).\n";
+    }
+    else if (fileName.empty()) {
+        // No preload configured: fall back to the interactive prompt.
+        std::cout << "Enter the course data file name: ";
+        std::getline(std::cin, fileName);
+        fileName = trim(fileName);
+    }
+
+    int choice = 0;
+    while (true) {
+        printMenu();
+        if (!readIntChoice(choice)) {
+            std::cout << "Invalid input. Please choose an option from the menu.\n";
+            continue;
+        }
+
+        if (choice == 1) {
+            if (fileName.empty()) {
+                std::cout << "Enter the course data file name: ";
+                std::getline(std::cin, fileName);
+                fileName = trim(fileName);
+            }
+
+            store.publish(loadCoursesFromFile(fileName,
+                store.shareBaseFor(store.activeName())));
+            if (!store.current()->empty()) {
+                dataLoaded = true;
+                std::cout << "Data loaded successfully (" << store.current()->size()
+                    << " courses).\n";
+            }
+            else {
+                dataLoaded = false;
+                std::cout << "No courses loaded. Check errors above and try again.\n";
+            }
+
+        }
+        else if (choice == 2) {
+            if (!dataLoaded) {
+                std::cout << "Please load data first (Option 1).\n";
+                continue;
+            }
+            printCourseListSorted(*store.current());
+
+        }
+        else if (choice == 3) {
+            if (!dataLoaded) {
+                std::cout << "Please load data first (Option 1).\n";
+                continue;
+            }
+            std::string courseNumber;
+            std::cout << "Enter a course number (e.g., CS200): ";
+            std::getline(std::cin, courseNumber);
+            printCourseInfo(*store.current(), courseNumber);
+
+        }
+        else if (choice == 4) {
+            if (!dataLoaded) {
+                std::cout << "Please load data first (Option 1).\n";
+                continue;
+            }
+            std::string snapName;
+            std::cout << "Enter the snapshot file name: ";
+            std::getline(std::cin, snapName);
+            snapName = trim(snapName);
+            if (snapName.empty()) {
+                std::cout << "No snapshot file name given.\n";
+                continue;
+            }
+            std::shared_ptr<const Catalog> snapCatalog = store.current();
+            if (saveSnapshot(*snapCatalog, snapName)) {
+                std::cout << "Snapshot saved (" << snapCatalog->size() << " courses).\n";
+            }
+
+        }
+        else if (choice == 5) {
+            std::string snapName;
+            std::cout << "Enter the snapshot file name: ";
+            std::getline(std::cin, snapName);
+            snapName = trim(snapName);
+            if (snapName.empty()) {
+                std::cout << "No snapshot file name given.\n";
+                continue;
+            }
+            store.publish(loadSnapshot(snapName));
+            if (!store.current()->empty()) {
+                dataLoaded = true;
+                std::cout << "Snapshot loaded (" << store.current()->size() << " courses).\n";
+            }
+            else {
+                dataLoaded = false;
+                std::cout << "No courses loaded from snapshot. Check errors above and try again.\n";
+            }
+
+        }
+        else if (choice == 6) {
+            if (!dataLoaded) {
+                std::cout << "Please load data first (Option 1).\n";
+                continue;
+            }
+            std::string courseNumber;
+            std::cout << "Enter a course number (e.g., CS200): ";
+            std::getline(std::cin, courseNumber);
+            std::string out;
+            appendCourseClosure(*store.current(), courseNumber, out);
+            std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+        }
+        else if (choice == 7) {
+            if (!dataLoaded) {
+                std::cout << "Please load data first (Option 1).\n";
+                continue;
+            }
+            std::string prefix;
+            std::cout << "Enter a course number prefix (e.g., CS2): ";
+            std::getline(std::cin, prefix);
+            std::string out;
+            appendPrefixMatches(*store.current(), prefix, out);
+            std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+        }
+        else if (choice == 8) {
+            if (!dataLoaded) {
+                std::cout << "Please load data first (Option 1).\n";
+                continue;
+            }
+            std::string deltaName;
+            std::cout << "Enter the delta file name: ";
+            std::getline(std::cin, deltaName);
+            deltaName = trim(deltaName);
+            if (deltaName.empty()) {
+                std::cout << "No delta file name given.\n";
+                continue;
+            }
+            Catalog next;
+            if (!applyDeltaFile(*store.current(), deltaName, next)) {
+                continue; // error already reported; keep the current generation
+            }
+            store.publish(std::move(next));
+            std::cout << "Delta applied (" << store.current()->size() << " courses).\n";
+            dataLoaded = !store.current()->empty();
+
+        }
+        else if (choice == 10) {
+            if (!dataLoaded) {
+                std::cout << "Please load data first (Option 1).\n";
+                continue;
+            }
+            std::string courseNumber;
+            std::cout << "Enter a course number (e.g., CS200): ";
+            std::getline(std::cin, courseNumber);
+            std::string out;
+            appendDependents(*store.current(), courseNumber, out);
+            std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+        }
+        else if (choice == 11) {
+            if (!dataLoaded) {
+                std::cout << "Please load data first (Option 1).\n";
+                continue;
+            }
+            std::string targetList;
+            std::cout << "Enter target course number(s): ";
+            std::getline(std::cin, targetList);
+            std::string out;
+            appendCoursePlan(*store.current(), targetList, out);
+            std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+        }
+        else if (choice == 12) {
+            if (!dataLoaded) {
+                std::cout << "Please load data first (Option 1).\n";
+                continue;
+            }
+            std::string courseNumbers;
+            std::cout << "Enter course numbers (space or comma separated): ";
+            std::getline(std::cin, courseNumbers);
+            std::string out;
+            appendCourseInfoBatch(*store.current(), courseNumbers, out);
+            std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+        }
+        else if (choice == 16) {
+            if (!dataLoaded) {
+                std::cout << "Please load data first (Option 1).\n";
+                continue;
+            }
+            std::string courseNumber;
+            std::cout << "Enter a course number (e.g., CS200): ";
+            std::getline(std::cin, courseNumber);
+            std::string out;
+            appendCourseMetrics(*store.current(), courseNumber, out);
+            std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+        }
+        else if (choice == 15) {
+            std::string out;
+            store.appendList(out);
+            std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+            std::string name;
+            std::cout << "Enter catalog name to activate (blank to keep current): ";
+            std::getline(std::cin, name);
+            name = trim(name);
+            if (!name.empty()) {
+                store.select(name);
+                dataLoaded = !store.current()->empty();
+                std::cout << "Active catalog: " << name << " ("
+                    << store.current()->size() << " courses).\n";
+                fileName.clear(); // option 1 will prompt for this term's file
+            }
+
+        }
+        else if (choice == 14) {
+            if (!dataLoaded) {
+                std::cout << "Please load data first (Option 1).\n";
+                continue;
+            }
+            std::string query;
+            std::cout << "Enter title keyword(s): ";
+            std::getline(std::cin, query);
+            std::string out;
+            appendTitleSearch(*store.current(), query, out);
+            std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+        }
+        else if (choice == 13) {
+            std::string out;
+            appendStats(out);
+            std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+
+        }
+        else if (choice == 9) {
+            std::cout << "Goodbye.\n";
+            break;
+
+        }
+        else {
+            std::cout << "Invalid option. Please choose an option from the menu.\n";
+        }
+    }
+
+    dumpStatsFile();
+    return 0;
 }
\ No newline at end of file